@@ -47,11 +47,42 @@ Application::Application(QWidget *parent)
      */
     controller->setPlayerWidget(ui->playerWidget);
 
+    /*!
+     * @brief 将菜单中的动作同时添加到主窗口，保证全屏隐藏菜单栏时快捷键依然有效
+     */
+    for (QAction *action: findChildren<QAction *>()) {
+        if (!action->shortcut().isEmpty()) {
+            addAction(action);
+        }
+    }
+
     /*!
      * @brief 在playerWidget上安装事件过滤器
      */
     ui->playerWidget->installEventFilter(this);
 
+    /*!
+     * @brief 鼠标悬停在进度条上时显示对应位置的缩略图
+     */
+    slider->setMouseTracking(true);
+    slider->installEventFilter(this);
+    initThumbnailPreview();
+
+    /*!
+     * @brief MPV错误在状态栏中提示，提示消失后隐藏状态栏，全屏时不显示
+     */
+    statusBar()->hide();
+    connect(statusBar(), &QStatusBar::messageChanged, this, [this](const QString &message) {
+        if (message.isEmpty()) {
+            statusBar()->hide();
+        }
+    });
+    connect(controller->getDiagnostics(), &Diagnostics::errorShown, this, [this](const QString &text) {
+        if (!isFullScreen) {
+            statusBar()->show();
+        }
+        statusBar()->showMessage(tr("错误：%1").arg(text), 8000);
+    });
 
     /*!
      * @brief 传递mpv实例给subtitle
@@ -59,6 +90,31 @@ Application::Application(QWidget *parent)
     mpv_handle *mpv = controller->getMpvInstance();
     subtitle = new Subtitle(mpv);
 
+    /*!
+     * @brief 当前帧截图
+     */
+    frameCapture = new FrameCapture(mpv, this);
+
+
+    /*!
+     * @brief 根据MPV推送的播放状态更新播放图标
+     */
+    connect(controller, &Controller::pauseChanged, this, [this](bool isPaused) {
+        updatePlayIcon(!isPaused);
+    });
+
+    /*!
+     * @brief 根据MPV推送的静音状态更新声音图标与勾选状态
+     */
+    connect(controller, &Controller::muteChanged, this, [this](bool isMute) {
+        updateVolumeIcon(isMute);
+        ui->muteAudio->setChecked(isMute);
+    });
+
+    /*!
+     * @brief 根据MPV推送的音量更新音量滑块
+     */
+    connect(controller, &Controller::volumeChanged, volumeAction, &VolumeAction::updateVolumeSlider);
 
     /*!
      * @brief 加载播放历史记录
@@ -106,6 +162,16 @@ Application::Application(QWidget *parent)
      */
     connect(ui->exitProgram, &QAction::triggered, this, &Application::on_actionExitProgram_triggered);
 
+    /*!
+     * @brief 导出诊断日志
+     */
+    connect(ui->exportDiagnostics, &QAction::triggered, this, &Application::on_actionExportDiagnostics_triggered);
+
+    /*!
+     * @brief 显示MPV日志窗口
+     */
+    connect(ui->showLog, &QAction::triggered, this, &Application::on_actionShowLog_triggered);
+
 
     /*!
      * @brief 播放暂停视频
@@ -219,6 +285,27 @@ Application::Application(QWidget *parent)
      */
     connect(ui->captureScreen, &QAction::triggered, this, &Application::on_actionCaptureScreen_triggered);
 
+    /*!
+     * @brief 快速截图，按截图选项直接保存，可连续触发
+     */
+    connect(ui->quickCapture, &QAction::triggered, frameCapture, &FrameCapture::capture);
+
+    /*!
+     * @brief 切换性能信息叠加层
+     */
+    performanceHud = new PerformanceHud(controller, this);
+    connect(ui->performanceHud, &QAction::toggled, performanceHud, &PerformanceHud::setVisible);
+
+    /*!
+     * @brief 截图结果在视频上以OSD提示，失败时弹窗
+     */
+    connect(frameCapture, &FrameCapture::captured, this, [this](const QString &fileName) {
+        controller->commandAsync({"show-text", tr("截图已保存：%1").arg(QDir::toNativeSeparators(fileName)), "2000"});
+    });
+    connect(frameCapture, &FrameCapture::captureFailed, this, [this](const QString &message) {
+        QMessageBox::critical(this, tr("错误"), message);
+    });
+
 
     /*!
      * @brief 视频下载
@@ -290,17 +377,141 @@ Application::Application(QWidget *parent)
      * @brief 跳转到下一帧
      */
     connect(ui->nextFrame, &QAction::triggered, this, &Application::on_actionNextFrame_triggered);
+
+    /*!
+     * @brief 设置A、B点并导出两点之间的每一帧
+     */
+    connect(ui->markPointA, &QAction::triggered, this, &Application::on_actionMarkPointA_triggered);
+    connect(ui->markPointB, &QAction::triggered, this, &Application::on_actionMarkPointB_triggered);
+    connect(ui->exportSequence, &QAction::triggered, this, &Application::on_actionExportSequence_triggered);
 }
 
 Application::~Application() {
+    /*!
+     * @brief 先等待后台截图任务结束，任务中使用了Controller的MPV实例，必须在下面释放Controller之前完成
+     */
+    delete frameCapture;
+    frameCapture = nullptr;
+
+    /*!
+     * @brief Controller没有父对象，需要手动释放，释放时会写出本次会话的"quit"记录并终止MPV实例；
+     * 统计叠加层析构时要取消属性监听，必须先于Controller释放
+     */
+    delete performanceHud;
+    performanceHud = nullptr;
+    delete controller;
+    controller = nullptr;
+
     delete ui;
     delete subtitle;
 }
 
+/*!
+ * @brief 创建进度条缩略图预览
+ */
+void Application::initThumbnailPreview() {
+    thumbnailProvider = new ThumbnailProvider(160, this);
+
+    /*!
+     * @brief 预览弹窗由缩略图与时间两部分组成
+     */
+    thumbnailPopup = new QWidget(this, Qt::ToolTip);
+    auto *layout = new QVBoxLayout(thumbnailPopup);
+    layout->setContentsMargins(2, 2, 2, 2);
+    layout->setSpacing(2);
+    thumbnailImage = new QLabel(thumbnailPopup);
+    thumbnailImage->setFixedSize(160, 90);
+    thumbnailImage->setAlignment(Qt::AlignCenter);
+    thumbnailImage->setStyleSheet("background-color: black;");
+    thumbnailTime = new QLabel(thumbnailPopup);
+    thumbnailTime->setAlignment(Qt::AlignCenter);
+    layout->addWidget(thumbnailImage);
+    layout->addWidget(thumbnailTime);
+
+    /*!
+     * @brief 新文件加载后切换缩略图来源
+     */
+    connect(controller, &Controller::fileLoaded, this, [this]() {
+        thumbnailProvider->setFile(controller->getCurrentFile());
+        thumbnailProvider->setDuration(controller->getDuration());
+    });
+    connect(controller, &Controller::durationChanged, thumbnailProvider, &ThumbnailProvider::setDuration);
+
+    /*!
+     * @brief 拼图生成后更新对应历史记录的图标
+     */
+    connect(thumbnailProvider, &ThumbnailProvider::sheetSaved, this, [this](const QString &path) {
+        for (QAction *action: historyActions) {
+            if (action->data().toString() == path) {
+                const QImage cover = ThumbnailSheet::loadCover(path);
+                if (!cover.isNull()) {
+                    action->setIcon(QIcon(QPixmap::fromImage(cover)));
+                }
+            }
+        }
+    });
+
+    /*!
+     * @brief 后台生成的缩略图正是当前悬停位置时立即显示
+     */
+    connect(thumbnailProvider, &ThumbnailProvider::thumbnailReady, this, [this](int second, const QImage &image) {
+        if (second == hoveredSecond && thumbnailPopup->isVisible()) {
+            thumbnailImage->setPixmap(QPixmap::fromImage(image));
+        }
+    });
+}
+
+/*!
+ * @brief 显示进度条x位置对应的缩略图，缓存中没有时先显示时间并请求生成
+ */
+void Application::showThumbnail(int x) {
+    if (!thumbnailProvider->hasFile() || slider->maximum() <= 0) {
+        return;
+    }
+
+    const int second = QStyle::sliderValueFromPosition(slider->minimum(), slider->maximum(), x, slider->width());
+    const int key = thumbnailProvider->keyFor(second);
+    thumbnailTime->setText(QTime(0, 0).addSecs(second).toString("hh:mm:ss"));
+
+    if (key != hoveredSecond) {
+        hoveredSecond = key;
+        QImage image;
+        if (thumbnailProvider->lookup(key, &image)) {
+            thumbnailImage->setPixmap(QPixmap::fromImage(image));
+        }
+        thumbnailProvider->request(key);
+    }
+
+    thumbnailPopup->adjustSize();
+    const QPoint anchor = slider->mapToGlobal(QPoint(x, 0));
+    thumbnailPopup->move(anchor.x() - thumbnailPopup->width() / 2, anchor.y() - thumbnailPopup->height() - 4);
+    thumbnailPopup->show();
+}
+
+/*!
+ * @brief 隐藏缩略图
+ */
+void Application::hideThumbnail() {
+    thumbnailPopup->hide();
+    thumbnailImage->clear();
+    hoveredSecond = -1;
+}
+
 /*!
  * @brief 重写eventFilter()方法
  */
 bool Application::eventFilter(QObject *watched, QEvent *event) {
+    /*!
+     * @brief 鼠标在进度条上移动时显示缩略图，离开时隐藏
+     */
+    if (watched == slider) {
+        if (event->type() == QEvent::MouseMove) {
+            showThumbnail(static_cast<QMouseEvent *>(event)->pos().x());
+        } else if (event->type() == QEvent::Leave || event->type() == QEvent::Hide) {
+            hideThumbnail();
+        }
+    }
+
     /*!
      * @brief 双击播放窗口切换全屏播放
      */
@@ -405,6 +616,14 @@ void Application::addHistory(const QString &filepath) {
      */
     auto *action = new QAction(QFileInfo(filepath).fileName(), this);
     action->setData(filepath);
+
+    /*!
+     * @brief 已生成过缩略图拼图的文件以封面缩略图作为图标
+     */
+    const QImage cover = ThumbnailSheet::loadCover(filepath);
+    if (!cover.isNull()) {
+        action->setIcon(QIcon(QPixmap::fromImage(cover)));
+    }
     connect(action, &QAction::triggered, [this, filepath]() {
         controller->openFile(filepath);  // 点击记录时打开对应文件
         filename = filepath;
@@ -433,6 +652,8 @@ void Application::addHistory(const QString &filepath) {
  * @brief 清除历史记录
  */
 void Application::on_actionClearHistory_triggered() {
+    TRACE_FUNCTION("ui");
+
     for (QAction *action: historyActions) {
         ui->menuHistory->removeAction(action);
         delete action;
@@ -446,6 +667,8 @@ void Application::on_actionClearHistory_triggered() {
  * @brief 打开视频文件
  */
 void Application::on_actionOpenFile_triggered() {
+    TRACE_FUNCTION("ui");
+
     /*!
      * @brief 弹出文件选择对话框让用户选择文件
      */
@@ -455,9 +678,20 @@ void Application::on_actionOpenFile_triggered() {
             "",
             tr("视频文件 (*.mpg *.mpeg *.avi *.mp4 *.mkv *.webm *.wmv *.mov *.flv *.m4v *.ogv *.3gp *.3g2);;"
                "音频文件 (*.mp3 *.aac *.ogg *.flac *.alac *.wav *.wv);;"
+               "归档文件 (*.zip *.tar);;"
                "所有文件 (*)")
     );
 
+    /*!
+     * @brief 选择的是归档文件时，让用户选择其中的成员，通过archive://协议直接读取
+     */
+    if (!filename.isEmpty() && ArchiveIndex::isArchive(filename)) {
+        filename = selectArchiveMember(filename);
+        if (filename.isEmpty()) {
+            return;
+        }
+    }
+
     /*!
      * @brief 在路径不为空的情况下打开文件
      */
@@ -469,10 +703,37 @@ void Application::on_actionOpenFile_triggered() {
     }
 }
 
+/*!
+ * @brief 列出归档中可直接播放的成员供用户选择，返回所选成员的archive://地址，取消时返回空字符串
+ */
+QString Application::selectArchiveMember(const QString &archivePath) {
+    const QSharedPointer<const ArchiveIndex> index = ArchiveIndex::load(archivePath);
+    if (!index) {
+        QMessageBox::critical(this, tr("错误"), tr("无法读取归档文件：%1").arg(archivePath));
+        return {};
+    }
+
+    const QStringList members = index->playableMembers();
+    if (members.isEmpty()) {
+        QMessageBox::critical(this, tr("错误"), tr("归档中没有可直接播放的成员，仅支持未压缩（存储方式）的成员"));
+        return {};
+    }
+
+    bool ok = false;
+    const QString member = QInputDialog::getItem(this, tr("打开归档文件"), tr("选择要播放的文件："),
+                                                 members, 0, false, &ok);
+    if (!ok || member.isEmpty()) {
+        return {};
+    }
+    return ArchiveIndex::toUri(archivePath, member);
+}
+
 /*!
  * @brief 打开URL
  */
 void Application::on_actionOpenURL_triggered() {
+    TRACE_FUNCTION("ui");
+
     QDialog dialog(this);
     QGridLayout layout(&dialog);
 
@@ -509,6 +770,8 @@ void Application::on_actionOpenURL_triggered() {
  * @brief 退出应用程序
  */
 void Application::on_actionExitProgram_triggered() {
+    TRACE_FUNCTION("ui");
+
     /*!
      * @brief 保存播放历史记录
      */
@@ -521,6 +784,8 @@ void Application::on_actionExitProgram_triggered() {
  * @brief 播放暂停视频
  */
 void Application::on_actionTogglePlayPause_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->togglePlayPause();
 }
 
@@ -550,34 +815,37 @@ void Application::updateVolumeIcon(bool isMute) const {
  * @brief 全屏播放
  */
 void Application::on_actionFullScreen_triggered() {
+    TRACE_FUNCTION("ui");
+
+    /*!
+     * @brief 切换主窗口本身的全屏状态，playerWidget不再重新挂载父窗口，避免OpenGL上下文被重建
+     */
     if (isFullScreen) {
         /*!
          * @brief 退出全屏
          */
         /*!
-         * @brief 恢复原来的窗口标志
-         */
-        ui->playerWidget->setWindowFlags(originalFlags);
-
-        /*!
-         * @brief 恢复原来的窗口状态
+         * @brief 恢复菜单栏与原来的窗口状态
          */
-        ui->playerWidget->showNormal();
+        menuBar()->show();
+        setWindowState(originalState);
         isFullScreen = false;
     } else {
         /*!
          * @brief 进入全屏
          */
         /*!
-         * @brief 保存当前的窗口标志
+         * @brief 保存当前的窗口状态
          */
-        originalFlags = ui->playerWidget->windowFlags();
+        originalState = windowState();
 
         /*!
-         * @brief 将playerWidget提升为顶级窗口
+         * @brief 隐藏菜单栏与工具栏，仅保留播放画面
          */
-        ui->playerWidget->setWindowFlags(Qt::Window);
-        ui->playerWidget->showFullScreen();
+        menuBar()->hide();
+        toolBar->hide();
+        statusBar()->hide();
+        setWindowState(originalState | Qt::WindowFullScreen);
         isFullScreen = true;
     }
 }
@@ -586,14 +854,20 @@ void Application::on_actionFullScreen_triggered() {
  * @brief 视频缩放控制
  */
 void Application::on_actionZoomIn_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->zoomIn();
 }
 
 void Application::on_actionZoomOut_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->zoomOut();
 }
 
 void Application::on_actionZoomReset_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->zoomReset();
 }
 
@@ -601,29 +875,73 @@ void Application::on_actionZoomReset_triggered() {
  * @brief 视频画面移动控制
  */
 void Application::on_actionMoveLeft_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->moveLeft();
 }
 
 void Application::on_actionMoveRight_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->moveRight();
 }
 
 void Application::on_actionMoveUp_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->moveUp();
 }
 
 void Application::on_actionMoveDown_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->moveDown();
 }
 
 void Application::on_actionMoveReset_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->moveReset();
 }
 
+/*!
+ * @brief 显示MPV日志窗口，窗口只创建一次
+ */
+void Application::on_actionShowLog_triggered() {
+    TRACE_FUNCTION("ui");
+
+    if (!logViewer) {
+        logViewer = new LogViewer(controller, this);
+    }
+    logViewer->show();
+    logViewer->raise();
+    logViewer->activateWindow();
+}
+
+/*!
+ * @brief 导出诊断日志
+ */
+void Application::on_actionExportDiagnostics_triggered() {
+    TRACE_FUNCTION("ui");
+
+    const QString fileName = QFileDialog::getSaveFileName(
+            this, tr("导出诊断日志"),
+            QDir::home().filePath("astraplay_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".log"),
+            tr("日志文件 (*.log *.txt)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (!controller->getDiagnostics()->exportLog(fileName)) {
+        QMessageBox::critical(this, tr("错误"), tr("无法写入诊断日志：%1").arg(fileName));
+    }
+}
+
 /*!
  * @brief 跳转到指定播放位置
  */
 void Application::on_slider_Released() {
+    TRACE_FUNCTION("ui");
+
     int seconds = slider->value();
     controller->seek(seconds);
 }
@@ -632,6 +950,8 @@ void Application::on_slider_Released() {
  * @brief 增加播放速度（0.5x）
  */
 void Application::on_actionSpeedUp_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->setSpeed(0.5);
 }
 
@@ -639,6 +959,8 @@ void Application::on_actionSpeedUp_triggered() {
  * @brief 减少播放速度（0.5x）
  */
 void Application::on_actionSpeedDown_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->setSpeed(-0.5);
 }
 
@@ -646,6 +968,8 @@ void Application::on_actionSpeedDown_triggered() {
  * @brief 重置播放速度
  */
 void Application::on_actionSpeedReset_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->setSpeed(0);
 }
 
@@ -653,6 +977,8 @@ void Application::on_actionSpeedReset_triggered() {
  * @brief 播放速度减少一半，播放视频
  */
 void Application::on_speedHalf_activated() {
+    TRACE_FUNCTION("ui");
+
     controller->setSpeedMultiple(0.5);
     controller->playVideo();
 }
@@ -661,6 +987,8 @@ void Application::on_speedHalf_activated() {
  * @brief 播放速度重置，切换播放状态
  */
 void Application::on_speedReset_activated() {
+    TRACE_FUNCTION("ui");
+
     controller->setSpeed(0);
     controller->togglePlayPause();
 }
@@ -669,6 +997,8 @@ void Application::on_speedReset_activated() {
  * @brief 播放速度增加一倍，播放视频
  */
 void Application::on_speedPlus_activated() {
+    TRACE_FUNCTION("ui");
+
     controller->setSpeedMultiple(2);
     controller->playVideo();
 }
@@ -678,6 +1008,8 @@ void Application::on_speedPlus_activated() {
  * @brief 后退3秒
  */
 void Application::on_actionToolBack_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->seekRelative(-3);
 }
 
@@ -685,6 +1017,8 @@ void Application::on_actionToolBack_triggered() {
  * @brief 前进3秒
  */
 void Application::on_actionToolForward_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->seekRelative(3);
 }
 
@@ -692,26 +1026,20 @@ void Application::on_actionToolForward_triggered() {
  * @brief 视频截图窗口
  */
 void Application::on_actionCaptureScreen_triggered() {
-    /*!
-     * @brief 获取mpv实例
-     */
-    mpv_handle *mpv = controller->getMpvInstance();
-
-    /*!
-     * @brief 创建截图窗口实例
-     */
-    auto *dialog = new ScreenCapture(mpv, this);
+    TRACE_FUNCTION("ui");
 
     /*!
      * @brief 显示截图窗口
      */
-    dialog->show();
+    ScreenCapture::present(screenCapture, controller->getMpvInstance(), frameCapture, this);
 }
 
 /*!
  * @brief 音频提前0.1s
  */
 void Application::on_actionAuAdvance_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->adjustAudio(-0.1);
 }
 
@@ -719,6 +1047,8 @@ void Application::on_actionAuAdvance_triggered() {
  * @brief 音频延后0.1s
  */
 void Application::on_actionAuDelay_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->adjustAudio(0.1);
 }
 
@@ -726,6 +1056,8 @@ void Application::on_actionAuDelay_triggered() {
  * @brief 音频同步重置
  */
 void Application::on_actionAuSyncReset_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->resetAudioSync();
 }
 
@@ -733,6 +1065,8 @@ void Application::on_actionAuSyncReset_triggered() {
  * @brief 音量增加10%
  */
 void Application::on_actionVolumeIncrease_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->setVolume(10, true);
 }
 
@@ -740,6 +1074,8 @@ void Application::on_actionVolumeIncrease_triggered() {
  * @brief 音量减少10%
  */
 void Application::on_actionVolumeDecrease_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->setVolume(-10, true);
 }
 
@@ -747,6 +1083,8 @@ void Application::on_actionVolumeDecrease_triggered() {
  * @brief 视频下载
  */
 void Application::on_actionVideoDownload_triggered() {
+    TRACE_FUNCTION("ui");
+
     QDialog dialog(this);
     QGridLayout layout(&dialog);
 
@@ -777,6 +1115,8 @@ void Application::on_actionVideoDownload_triggered() {
  * @brief 下载过程中的错误处理
  */
 void Application::on_DownloadError(const QString &error) {
+    TRACE_FUNCTION("ui");
+
     /*!
      * @brief 创建一个消息框来显示错误
      */
@@ -799,6 +1139,8 @@ void Application::on_DownloadError(const QString &error) {
  * @brief 下载完成处理
  */
 void Application::on_DownloadFinished(const QString &folderPath) {
+    TRACE_FUNCTION("ui");
+
     auto *finishedMessageBox = new QMessageBox;
     finishedMessageBox->setWindowTitle(tr("下载完成"));
     finishedMessageBox->setText(tr("视频已成功下载！"));
@@ -864,6 +1206,8 @@ void Application::on_DownloadFinished(const QString &folderPath) {
  * @brief 读取视频元数据
  */
 void Application::on_actionReadRaw_triggered() {
+    TRACE_FUNCTION("ui");
+
     mediaInfo->readRawAttribute(filename);
 }
 
@@ -871,6 +1215,8 @@ void Application::on_actionReadRaw_triggered() {
  * @brief 加载外挂字幕
  */
 void Application::on_actionAddSubtitle_triggered() {
+    TRACE_FUNCTION("ui");
+
     QString subFilename = QFileDialog::getOpenFileName(this, tr("打开字幕文件"), "",
                                                        tr("字幕文件 (*.srt *.ass *.ssa *.sub)"));
     if (!subFilename.isEmpty()) {
@@ -882,6 +1228,8 @@ void Application::on_actionAddSubtitle_triggered() {
  * @brief 字幕列表
  */
 void Application::on_actionSubtitleList_triggered() {
+    TRACE_FUNCTION("ui");
+
     QDialog dialog(this);
     dialog.setWindowTitle(tr("字幕列表"));
 
@@ -933,6 +1281,8 @@ void Application::on_actionSubtitleList_triggered() {
  * @brief 字幕控制
  */
 void Application::on_subtitleControl_clicked() {
+    TRACE_FUNCTION("ui");
+
     QDialog dialog(this);
     dialog.setWindowTitle(tr("字幕控制"));
 
@@ -1025,6 +1375,8 @@ void Application::on_subtitleControl_clicked() {
  * @brief 跳转到上一帧
  */
 void Application::on_actionFrontFrame_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->goToPreviousFrame();
 }
 
@@ -1032,9 +1384,89 @@ void Application::on_actionFrontFrame_triggered() {
  * @brief 跳转到下一帧
  */
 void Application::on_actionNextFrame_triggered() {
+    TRACE_FUNCTION("ui");
+
     controller->goToNextFrame();
 }
 
+/*!
+ * @brief 将当前位置设为A点
+ */
+void Application::on_actionMarkPointA_triggered() {
+    TRACE_FUNCTION("ui");
+
+    pointA = controller->getTimePos();
+    controller->commandAsync({"show-text", tr("A点：%1").arg(pointA, 0, 'f', 3)});
+}
+
+/*!
+ * @brief 将当前位置设为B点
+ */
+void Application::on_actionMarkPointB_triggered() {
+    TRACE_FUNCTION("ui");
+
+    pointB = controller->getTimePos();
+    controller->commandAsync({"show-text", tr("B点：%1").arg(pointB, 0, 'f', 3)});
+}
+
+/*!
+ * @brief 在后台导出A、B两点之间的每一帧，不影响当前播放
+ */
+void Application::on_actionExportSequence_triggered() {
+    TRACE_FUNCTION("ui");
+
+    if (pointA < 0 || pointB <= pointA) {
+        QMessageBox::critical(this, tr("错误"), tr("请先设置A点与B点，且B点需在A点之后"));
+        return;
+    }
+
+    const QString directory = QFileDialog::getExistingDirectory(this, tr("选择帧序列保存目录"), "",
+                                                                QFileDialog::ShowDirsOnly);
+    if (directory.isEmpty()) {
+        return;
+    }
+    bool ok = false;
+    const QString format = QInputDialog::getItem(this, tr("导出A-B帧序列"), tr("图片格式："),
+                                                 {"png", "jpg"}, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+
+    /*!
+     * @brief 进度按已解码的位置在A、B之间的比例显示；对话框按Esc或关闭按钮关闭时会立即删除，
+     * 导出线程仍在取消中，因此用QPointer持有，完成时先判断是否还存在
+     */
+    auto *exporter = new SequenceExporter(this);
+    QPointer<QProgressDialog> progress = new QProgressDialog(tr("正在导出帧序列……"), tr("取消"), 0, 1000, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+
+    const double start = pointA, end = pointB;
+    connect(progress, &QProgressDialog::canceled, exporter, &SequenceExporter::cancel);
+    connect(exporter, &SequenceExporter::progressChanged, progress,
+            [progress, start, end](int exported, double position, double framesPerSecond) {
+                progress->setValue(qBound(0, static_cast<int>((position - start) / (end - start) * 1000), 999));
+                progress->setLabelText(tr("已导出%1帧，%2帧/秒").arg(exported).arg(framesPerSecond, 0, 'f', 1));
+            });
+    connect(exporter, &SequenceExporter::finished, this,
+            [this, exporter, progress, directory](int exported, double framesPerSecond, bool cancelled) {
+                if (progress) {
+                    progress->close();
+                }
+                exporter->deleteLater();
+                QMessageBox::information(this, tr("导出A-B帧序列"),
+                                         tr("%1：共导出%2帧，平均%3帧/秒\n保存目录：%4")
+                                                 .arg(cancelled ? tr("已取消") : tr("已完成"))
+                                                 .arg(exported)
+                                                 .arg(framesPerSecond, 0, 'f', 1)
+                                                 .arg(QDir::toNativeSeparators(directory)));
+            });
+
+    exporter->start(controller->getCurrentFile(), start, end, directory,
+                    QFileInfo(controller->getCurrentFile()).completeBaseName(), format.toLatin1());
+}
+
 /*!
  * @brief 给Controller类提供slider用于对播放进度滑块进行初始化与更新操作
  */
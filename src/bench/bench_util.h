@@ -0,0 +1,61 @@
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTimer>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * @brief 计算已排序样本的百分位数
+ */
+inline double percentile(const std::vector<qint64> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+}
+
+/*!
+ * @brief 处理事件直到条件满足或超时，返回条件是否满足
+ */
+inline bool waitUntil(const std::function<bool()> &done, int timeoutMs) {
+    QTimer deadline;
+    deadline.setSingleShot(true);
+    deadline.start(timeoutMs);
+    while (!done() && deadline.isActive()) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    return done();
+}
+
+/*!
+ * @brief 把文件逐出页缓存，之后的读取来自存储设备；文件仍被映射的页不会被逐出，调用前应先关闭文件。
+ * 目前只支持Linux，其他平台返回false
+ */
+inline bool evictFromPageCache(const QString &path) {
+#ifdef Q_OS_LINUX
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    ::fdatasync(fd);
+    const bool evicted = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return evicted;
+#else
+    Q_UNUSED(path)
+    return false;
+#endif
+}
+
+#endif //BENCH_UTIL_H
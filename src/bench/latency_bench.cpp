@@ -0,0 +1,327 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "controller.h"
+#include "bench_util.h"
+#include "synthetic_media.h"
+
+/*!
+ * @brief 基准程序自己监听的属性，与Controller、统计模块的reply_userdata错开
+ */
+static constexpr uint64_t timePosObserver = 0x4c415400;
+
+/*!
+ * @brief 一类操作的样本，单位为微秒
+ */
+struct Operation {
+    std::vector<qint64> samples;
+
+    int failures = 0;
+};
+
+/*!
+ * @brief 样本汇总为JSON，时间单位为微秒
+ */
+static QJsonObject summarize(const Operation &operation) {
+    std::vector<qint64> sorted = operation.samples;
+    std::sort(sorted.begin(), sorted.end());
+    QJsonObject result;
+    result["count"] = static_cast<qint64>(sorted.size());
+    result["failures"] = operation.failures;
+    result["p50_us"] = percentile(sorted, 0.50);
+    result["p95_us"] = percentile(sorted, 0.95);
+    result["p99_us"] = percentile(sorted, 0.99);
+    result["max_us"] = sorted.empty() ? 0.0 : static_cast<double>(sorted.back());
+    return result;
+}
+
+/*!
+ * @brief 打开与跳转延迟基准测试：用合成媒体按固定脚本驱动无界面的Controller，
+ * 输出每类操作的延迟分布（一行JSON），同一种子下操作序列完全相同，便于逐次提交对比
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("astraplay-latency-bench");
+
+    /*!
+     * @brief 解析命令行参数
+     */
+    QCommandLineParser parser;
+    parser.setApplicationDescription("AstraPlay open / seek / frame-step / track-switch latency benchmark");
+    parser.addHelpOption();
+    QCommandLineOption mediaOption("media", "Use this file instead of generating synthetic media.", "file");
+    QCommandLineOption durationOption("duration", "Length of the generated media.", "seconds", "30");
+    QCommandLineOption iterationsOption("iterations", "Samples per operation.", "N", "50");
+    QCommandLineOption burstOption("burst", "Relative seeks per burst.", "N", "8");
+    QCommandLineOption seedOption("seed", "Seed for the random seek positions.", "seed", "1");
+    QCommandLineOption timeoutOption("timeout", "Count an operation as failed after this long.", "ms", "5000");
+    QCommandLineOption sizeOption("size", "Render target size.", "WxH", "640x360");
+    parser.addOptions({mediaOption, durationOption, iterationsOption, burstOption, seedOption, timeoutOption,
+                       sizeOption});
+    parser.process(app);
+
+    const int iterations = parser.value(iterationsOption).toInt();
+    const int burst = parser.value(burstOption).toInt();
+    const int timeoutMs = parser.value(timeoutOption).toInt();
+    const quint32 seed = parser.value(seedOption).toUInt();
+    const QStringList size = parser.value(sizeOption).split('x');
+    const int width = size.value(0).toInt();
+    const int height = size.value(1).toInt();
+    if (iterations <= 0 || burst <= 0 || timeoutMs <= 0 || width <= 0 || height <= 0) {
+        std::fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+
+    /*!
+     * @brief 准备媒体与两条外挂字幕，全部放在临时目录中，退出时删除
+     */
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        std::fprintf(stderr, "cannot create temporary directory\n");
+        return 1;
+    }
+    int duration = parser.value(durationOption).toInt();
+    QString media = parser.value(mediaOption);
+    if (media.isEmpty()) {
+        if (duration < 10) {
+            std::fprintf(stderr, "--duration must be at least 10 seconds\n");
+            return 1;
+        }
+        media = workDir.filePath("synthetic.mkv");
+        QString error;
+        if (!SyntheticMedia::generate(media, duration, &error)) {
+            std::fprintf(stderr, "cannot generate media: %s\n", qPrintable(error));
+            return 1;
+        }
+    }
+    const QString subtitleA = workDir.filePath("a.srt");
+    const QString subtitleB = workDir.filePath("b.srt");
+
+    /*!
+     * @brief 以无界面模式创建Controller；文件末尾保持打开，靠近结尾的跳转不会结束播放
+     */
+    Controller controller(nullptr);
+    controller.setProperty("keep-open", "yes");
+    controller.setProperty("loop-file", "no");
+
+    const size_t stride = (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
+    std::vector<uchar> buffer(stride * static_cast<size_t>(height));
+    if (!controller.setSoftwareRenderTarget(buffer.data(), width, height, stride)) {
+        return 1;
+    }
+
+    /*!
+     * @brief 完成时刻在信号处理中记录，不受等待循环唤醒时机的影响
+     */
+    QElapsedTimer clock;
+    clock.start();
+    int restarts = 0;
+    qint64 restartAt = 0;
+    int endings = 0;
+    int timePosChanges = 0;
+    qint64 timePosAt = 0;
+    QObject::connect(&controller, &Controller::playbackRestarted, [&]() {
+        ++restarts;
+        restartAt = clock.nsecsElapsed();
+    });
+    QObject::connect(&controller, &Controller::fileEnded, [&endings](int) { ++endings; });
+    QObject::connect(&controller, &Controller::observedPropertyChanged, [&](const MpvEvent &event) {
+        if (event.replyUserdata == timePosObserver && event.format != MPV_FORMAT_NONE) {
+            ++timePosChanges;
+            timePosAt = clock.nsecsElapsed();
+        }
+    });
+    mpv_observe_property(controller.getMpvInstance(), timePosObserver, "time-pos", MPV_FORMAT_DOUBLE);
+
+    QMap<QString, Operation> operations;
+
+    /*!
+     * @brief 执行一次操作，counter增加即视为完成，延迟取到completedAt为止
+     */
+    const auto measure = [&](Operation &operation, const std::function<void()> &action, const int &counter,
+                             const qint64 &completedAt) {
+        const int before = counter;
+        const qint64 started = clock.nsecsElapsed();
+        action();
+        if (waitUntil([&]() { return counter > before; }, timeoutMs)) {
+            operation.samples.push_back((completedAt - started) / 1000);
+        } else {
+            ++operation.failures;
+        }
+    };
+
+    /*!
+     * @brief 不计入结果的准备动作，跳转后等待画面就绪
+     */
+    const auto seekAndSettle = [&](int seconds) {
+        const int before = restarts;
+        controller.seek(seconds);
+        waitUntil([&]() { return restarts > before; }, timeoutMs);
+    };
+
+    /*!
+     * @brief 冷打开：从loadfile到第一次PLAYBACK_RESTART（首帧可显示）。每次先关闭文件并把它逐出页缓存，
+     * 文件头与索引都要从存储读取；无法逐出页缓存的平台不测量
+     */
+    bool coldOpenSupported = true;
+    for (int i = 0; i < iterations && coldOpenSupported; ++i) {
+        if (i > 0) {
+            const int before = endings;
+            controller.command({"stop"});
+            waitUntil([&]() { return endings > before; }, timeoutMs);
+        }
+        coldOpenSupported = evictFromPageCache(media);
+        if (coldOpenSupported) {
+            measure(operations["open_cold"], [&]() { controller.openFile(media); }, restarts, restartAt);
+        }
+    }
+
+    /*!
+     * @brief 热打开：文件已在页缓存中，反复打开同一个文件，主要反映解复用与解码器初始化的开销
+     */
+    Operation &warmOpen = operations["open_warm"];
+    for (int i = 0; i < iterations; ++i) {
+        measure(warmOpen, [&]() { controller.openFile(media); }, restarts, restartAt);
+    }
+    if (warmOpen.samples.empty()) {
+        std::fprintf(stderr, "media could not be opened\n");
+        return 1;
+    }
+    const double loadedDuration = controller.get<MpvProperty::Duration>();
+    if (loadedDuration >= 1.0) {
+        duration = static_cast<int>(loadedDuration);
+    }
+    if (duration < 10) {
+        std::fprintf(stderr, "media must be at least 10 seconds long\n");
+        return 1;
+    }
+
+    /*!
+     * @brief 其余场景在暂停状态下进行，避免播放本身的解码负载影响测量
+     */
+    controller.set<MpvProperty::Pause>(true);
+
+    /*!
+     * @brief 绝对跳转：固定种子的随机位置，精确跳转到画面就绪
+     */
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> position(1, duration - 2);
+    Operation &absoluteSeek = operations["seek_absolute"];
+    for (int i = 0; i < iterations; ++i) {
+        const int target = position(random);
+        measure(absoluteSeek, [&]() { controller.seek(target); }, restarts, restartAt);
+    }
+
+    /*!
+     * @brief 相对跳转连发：模拟按住方向键，合并后的最后一次跳转完成即为结束；
+     * 连续settleMs没有新的PLAYBACK_RESTART才认为已经停下
+     */
+    constexpr int settleMs = 250;
+    const int burstStart = qMax(1, qMin(5, duration - burst - 2));
+    Operation &relativeBurst = operations["seek_relative_burst"];
+    for (int i = 0; i < iterations; ++i) {
+        seekAndSettle(burstStart);
+        const int before = restarts;
+        const qint64 started = clock.nsecsElapsed();
+        for (int j = 0; j < burst; ++j) {
+            controller.seekRelative(1);
+        }
+        if (!waitUntil([&]() { return restarts > before; }, timeoutMs)) {
+            ++relativeBurst.failures;
+            continue;
+        }
+        int seen;
+        do {
+            seen = restarts;
+            waitUntil([&]() { return restarts > seen; }, settleMs);
+        } while (restarts > seen);
+        relativeBurst.samples.push_back((restartAt - started) / 1000);
+    }
+
+    /*!
+     * @brief 逐帧：前进与后退各一次为一轮，到新画面的播放位置报告为止
+     */
+    seekAndSettle(duration / 2);
+    Operation &frameForward = operations["frame_step_forward"];
+    Operation &frameBackward = operations["frame_step_backward"];
+    for (int i = 0; i < iterations; ++i) {
+        measure(frameForward, [&]() { controller.goToNextFrame(); }, timePosChanges, timePosAt);
+        measure(frameBackward, [&]() { controller.goToPreviousFrame(); }, timePosChanges, timePosAt);
+    }
+
+    /*!
+     * @brief 切换字幕轨道：在两条外挂字幕之间交替，到MPV确认设置完成为止
+     */
+    Operation &trackSwitch = operations["track_switch"];
+    if (SyntheticMedia::generateSubtitle(subtitleA, duration, "A") &&
+        SyntheticMedia::generateSubtitle(subtitleB, duration, "B")) {
+        int added = 0;
+        const auto onAdded = [&added](int, const QVariant &) { ++added; };
+        controller.commandAsync({"sub-add", subtitleA, "auto"}, onAdded);
+        controller.commandAsync({"sub-add", subtitleB, "auto"}, onAdded);
+        waitUntil([&]() { return added == 2; }, timeoutMs);
+
+        QList<int64_t> subtitleTracks;
+        for (const QVariant &track: controller.getProperty("track-list").toList()) {
+            const QVariantMap map = track.toMap();
+            if (map.value("type").toString() == "sub") {
+                subtitleTracks.append(map.value("id").toLongLong());
+            }
+        }
+        if (subtitleTracks.size() >= 2) {
+            seekAndSettle(duration / 2);
+            int replies = 0;
+            qint64 replyAt = 0;
+            for (int i = 0; i < iterations; ++i) {
+                const int64_t track = subtitleTracks[i % 2];
+                measure(trackSwitch, [&]() {
+                    controller.setAsync<MpvProperty::SubtitleTrack>(track, [&](int, const QVariant &) {
+                        ++replies;
+                        replyAt = clock.nsecsElapsed();
+                    });
+                }, replies, replyAt);
+            }
+        } else {
+            trackSwitch.failures = iterations;
+        }
+    } else {
+        trackSwitch.failures = iterations;
+    }
+
+    mpv_unobserve_property(controller.getMpvInstance(), timePosObserver);
+
+    /*!
+     * @brief 汇总结果
+     */
+    QJsonObject results;
+    int failures = 0;
+    for (auto it = operations.constBegin(); it != operations.constEnd(); ++it) {
+        results[it.key()] = summarize(it.value());
+        failures += it.value().failures;
+    }
+
+    QJsonObject result;
+    result["media"] = parser.isSet(mediaOption) ? media : QString("synthetic");
+    result["duration"] = duration;
+    result["iterations"] = iterations;
+    result["burst"] = burst;
+    result["seed"] = static_cast<qint64>(seed);
+    result["cold_open_supported"] = coldOpenSupported;
+    result["operations"] = results;
+    result["failures"] = failures;
+    result["wall_ms"] = clock.elapsed();
+
+    std::printf("%s\n", QJsonDocument(result).toJson(QJsonDocument::Compact).constData());
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "controller.h"
+#include "bench_util.h"
+
+/*!
+ * @brief 解码+软件渲染吞吐基准测试，输出一行JSON便于在CI中逐次提交对比
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("astraplay-bench");
+
+    /*!
+     * @brief 解析命令行参数
+     */
+    QCommandLineParser parser;
+    parser.setApplicationDescription("AstraPlay decode + render throughput benchmark (software renderer)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("media", "Media file or URL to play.");
+    QCommandLineOption framesOption("frames", "Stop after N rendered frames (0 = play to the end).", "N", "0");
+    QCommandLineOption sizeOption("size", "Render target size.", "WxH", "1280x720");
+    QCommandLineOption hwdecOption("hwdec", "Value for the mpv hwdec option.", "mode", "no");
+    QCommandLineOption timeoutOption("timeout", "Abort after this many seconds.", "seconds", "600");
+    parser.addOptions({framesOption, sizeOption, hwdecOption, timeoutOption});
+    parser.process(app);
+
+    if (parser.positionalArguments().isEmpty()) {
+        parser.showHelp(1);
+    }
+    const QString media = parser.positionalArguments().first();
+    const quint64 maxFrames = parser.value(framesOption).toULongLong();
+    const QStringList size = parser.value(sizeOption).split('x');
+    const int width = size.value(0).toInt();
+    const int height = size.value(1).toInt();
+    if (width <= 0 || height <= 0) {
+        std::fprintf(stderr, "invalid --size\n");
+        return 1;
+    }
+
+    /*!
+     * @brief 以无界面模式创建Controller，不等待帧的显示时间，尽可能快地解码与渲染
+     */
+    Controller controller(nullptr);
+    controller.set<MpvProperty::Untimed>(true);
+    controller.setProperty("loop-file", "no");
+    controller.setProperty("aid", "no");
+    controller.setProperty("hwdec", parser.value(hwdecOption));
+
+    /*!
+     * @brief 调用方持有的渲染缓冲区，每行按64字节对齐
+     */
+    const size_t stride = (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
+    std::vector<uchar> buffer(stride * static_cast<size_t>(height));
+    SoftwareRenderer *renderer = controller.setSoftwareRenderTarget(buffer.data(), width, height, stride);
+    if (!renderer) {
+        return 1;
+    }
+    renderer->setBlockForTargetTime(false);
+
+    std::vector<qint64> renderTimes;
+    QElapsedTimer wallClock;
+    qint64 loadTime = -1;
+    bool timedOut = false;
+
+    QObject::connect(&controller, &Controller::fileLoaded, [&]() {
+        loadTime = wallClock.elapsed();
+    });
+    QObject::connect(renderer, &SoftwareRenderer::framePresented, [&](const FrameTiming &timing) {
+        renderTimes.push_back(timing.renderTime);
+        if (maxFrames > 0 && renderTimes.size() >= maxFrames) {
+            QCoreApplication::quit();
+        }
+    });
+    QObject::connect(&controller, &Controller::fileEnded, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    QTimer::singleShot(parser.value(timeoutOption).toInt() * 1000, &app, [&timedOut]() {
+        timedOut = true;
+        QCoreApplication::quit();
+    });
+
+    wallClock.start();
+    controller.openFile(media);
+    QCoreApplication::exec();
+    const qint64 elapsed = wallClock.elapsed();
+
+    /*!
+     * @brief 属性读取的单次开销，对比QVariant路径与原生格式路径
+     */
+    constexpr int propertyIterations = 10000;
+    QElapsedTimer propertyTimer;
+    propertyTimer.start();
+    for (int i = 0; i < propertyIterations; ++i) {
+        (void) controller.getProperty("volume");
+    }
+    const double variantGetNs = static_cast<double>(propertyTimer.nsecsElapsed()) / propertyIterations;
+    propertyTimer.restart();
+    for (int i = 0; i < propertyIterations; ++i) {
+        (void) controller.get<MpvProperty::Volume>();
+    }
+    const double typedGetNs = static_cast<double>(propertyTimer.nsecsElapsed()) / propertyIterations;
+
+    /*!
+     * @brief 汇总结果，时间单位为微秒
+     */
+    std::vector<qint64> sorted = renderTimes;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (qint64 value: sorted) {
+        total += static_cast<double>(value);
+    }
+    const qint64 playTime = loadTime >= 0 ? elapsed - loadTime : elapsed;
+
+    QJsonObject result;
+    result["media"] = media;
+    result["width"] = width;
+    result["height"] = height;
+    result["frames"] = static_cast<qint64>(sorted.size());
+    result["load_ms"] = loadTime;
+    result["wall_ms"] = elapsed;
+    result["fps"] = playTime > 0 ? static_cast<double>(sorted.size()) * 1000.0 / static_cast<double>(playTime) : 0.0;
+    result["render_us_mean"] = sorted.empty() ? 0.0 : total / static_cast<double>(sorted.size());
+    result["render_us_p50"] = percentile(sorted, 0.50);
+    result["render_us_p95"] = percentile(sorted, 0.95);
+    result["render_us_max"] = sorted.empty() ? 0.0 : static_cast<double>(sorted.back());
+    result["property_get_ns_variant"] = variantGetNs;
+    result["property_get_ns_typed"] = typedGetNs;
+    result["timed_out"] = timedOut;
+
+    std::printf("%s\n", QJsonDocument(result).toJson(QJsonDocument::Compact).constData());
+    return (sorted.empty() || timedOut) ? 1 : 0;
+}
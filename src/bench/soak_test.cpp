@@ -0,0 +1,263 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "controller.h"
+#include "subtitle.h"
+#include "screen_capture.h"
+#include "frame_capture.h"
+#include "bench_util.h"
+#include "synthetic_media.h"
+
+/*!
+ * @brief 进程资源占用，无法读取时为-1
+ */
+struct ResourceSample {
+    qint64 rssKb = -1;
+
+    int fds = -1;
+
+    int threads = -1;
+};
+
+/*!
+ * @brief 读取当前进程的常驻内存、打开的文件描述符数与线程数，目前只支持Linux的/proc
+ */
+static ResourceSample sampleResources() {
+    ResourceSample sample;
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        for (const QByteArray &line: status.readAll().split('\n')) {
+            if (line.startsWith("VmRSS:")) {
+                sample.rssKb = line.mid(6).trimmed().split(' ').value(0).toLongLong();
+            } else if (line.startsWith("Threads:")) {
+                sample.threads = line.mid(8).trimmed().toInt();
+            }
+        }
+    }
+
+    /*!
+     * @brief 列目录本身占用的描述符也会被计入，每次采样相同，不影响增长量
+     */
+    sample.fds = static_cast<int>(QDir("/proc/self/fd")
+            .entryList(QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot).size());
+#endif
+    return sample;
+}
+
+static QJsonObject toJson(const ResourceSample &sample) {
+    QJsonObject result;
+    result["rss_kb"] = sample.rssKb;
+    result["fds"] = sample.fds;
+    result["threads"] = sample.threads;
+    return result;
+}
+
+/*!
+ * @brief 长时间压力测试：反复执行打开→播放→跳转→切换字幕→截图窗口→关闭，
+ * 热身后记录基线，之后定期采样，内存、描述符或线程数相对基线的增长超过阈值即判定失败
+ */
+int main(int argc, char *argv[]) {
+    /*!
+     * @brief 截图窗口需要QApplication，默认使用offscreen平台，无显示器的机器上也能运行
+     */
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("astraplay-soak");
+
+    /*!
+     * @brief 解析命令行参数
+     */
+    QCommandLineParser parser;
+    parser.setApplicationDescription("AstraPlay soak test tracking memory, fd and thread growth");
+    parser.addHelpOption();
+    QCommandLineOption mediaOption("media", "Use this file instead of generating synthetic media.", "file");
+    QCommandLineOption durationOption("duration", "Stop after this many seconds.", "seconds", "3600");
+    QCommandLineOption cyclesOption("cycles", "Stop after N cycles (0 = no limit).", "N", "0");
+    QCommandLineOption warmupOption("warmup", "Cycles to run before taking the baseline.", "N", "5");
+    QCommandLineOption sampleOption("sample-every", "Sample resources every N cycles.", "N", "10");
+    QCommandLineOption playOption("play", "Playback time per cycle.", "ms", "2000");
+    QCommandLineOption seeksOption("seeks", "Absolute seeks per cycle.", "N", "5");
+    QCommandLineOption seedOption("seed", "Seed for the random seek positions.", "seed", "1");
+    QCommandLineOption timeoutOption("timeout", "Count an operation as failed after this long.", "ms", "10000");
+    QCommandLineOption rssOption("max-rss-growth", "Allowed RSS growth over the baseline.", "MiB", "64");
+    QCommandLineOption fdOption("max-fd-growth", "Allowed open fd growth over the baseline.", "N", "8");
+    QCommandLineOption threadOption("max-thread-growth", "Allowed thread growth over the baseline.", "N", "4");
+    parser.addOptions({mediaOption, durationOption, cyclesOption, warmupOption, sampleOption, playOption,
+                       seeksOption, seedOption, timeoutOption, rssOption, fdOption, threadOption});
+    parser.process(app);
+
+    const qint64 durationMs = parser.value(durationOption).toLongLong() * 1000;
+    const int maxCycles = parser.value(cyclesOption).toInt();
+    const int warmup = qMax(1, parser.value(warmupOption).toInt());
+    const int sampleEvery = qMax(1, parser.value(sampleOption).toInt());
+    const int playMs = parser.value(playOption).toInt();
+    const int seeks = parser.value(seeksOption).toInt();
+    const int timeoutMs = parser.value(timeoutOption).toInt();
+    const qint64 maxRssGrowthKb = parser.value(rssOption).toLongLong() * 1024;
+    const int maxFdGrowth = parser.value(fdOption).toInt();
+    const int maxThreadGrowth = parser.value(threadOption).toInt();
+
+    /*!
+     * @brief 准备媒体与两条外挂字幕
+     */
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        std::fprintf(stderr, "cannot create temporary directory\n");
+        return 1;
+    }
+    constexpr int mediaDuration = 30;
+    QString media = parser.value(mediaOption);
+    if (media.isEmpty()) {
+        media = workDir.filePath("synthetic.mkv");
+        QString error;
+        if (!SyntheticMedia::generate(media, mediaDuration, &error)) {
+            std::fprintf(stderr, "cannot generate media: %s\n", qPrintable(error));
+            return 1;
+        }
+    }
+    const QString subtitleA = workDir.filePath("a.srt");
+    const QString subtitleB = workDir.filePath("b.srt");
+    if (!SyntheticMedia::generateSubtitle(subtitleA, mediaDuration, "A") ||
+        !SyntheticMedia::generateSubtitle(subtitleB, mediaDuration, "B")) {
+        std::fprintf(stderr, "cannot write subtitles\n");
+        return 1;
+    }
+
+    /*!
+     * @brief 与主程序相同的组件，Controller以无界面模式渲染到内存
+     */
+    Controller controller(nullptr);
+    controller.setProperty("loop-file", "no");
+    constexpr int width = 320;
+    constexpr int height = 180;
+    const size_t stride = static_cast<size_t>(width) * 4;
+    std::vector<uchar> buffer(stride * height);
+    if (!controller.setSoftwareRenderTarget(buffer.data(), width, height, stride)) {
+        return 1;
+    }
+    mpv_handle *mpv = controller.getMpvInstance();
+    Subtitle subtitle(mpv);
+    FrameCapture frameCapture(mpv);
+
+    int restarts = 0;
+    int endings = 0;
+    QObject::connect(&controller, &Controller::playbackRestarted, [&restarts]() { ++restarts; });
+    QObject::connect(&controller, &Controller::fileEnded, [&endings](int) { ++endings; });
+
+    ScreenCapture *screenCapture = nullptr;
+    int failures = 0;
+    const auto await = [&](const int &counter, int before) {
+        if (!waitUntil([&]() { return counter > before; }, timeoutMs)) {
+            ++failures;
+        }
+    };
+
+    std::mt19937 random(parser.value(seedOption).toUInt());
+    std::uniform_int_distribution<int> position(1, mediaDuration - 2);
+    ResourceSample baseline;
+    ResourceSample last;
+    QString exceeded;
+    QElapsedTimer clock;
+    clock.start();
+    int cycle = 0;
+
+    while ((maxCycles == 0 || cycle < maxCycles) && clock.elapsed() < durationMs && exceeded.isEmpty()) {
+        /*!
+         * @brief 打开并播放
+         */
+        int before = restarts;
+        controller.openFile(media);
+        await(restarts, before);
+        waitUntil([]() { return false; }, playMs);
+
+        /*!
+         * @brief 跳转
+         */
+        for (int i = 0; i < seeks; ++i) {
+            before = restarts;
+            controller.seek(position(random));
+            await(restarts, before);
+        }
+
+        /*!
+         * @brief 加载并切换字幕，外挂字幕的轨道号从1开始
+         */
+        subtitle.loadSubtitle(subtitleA);
+        subtitle.loadSubtitle(subtitleB);
+        subtitle.setSubtitleTrack(1);
+        subtitle.setSubtitleTrack(2);
+        (void) subtitle.getSubtitleList();
+
+        /*!
+         * @brief 与主窗口相同，通过ScreenCapture::present()打开截图窗口，再关闭
+         */
+        ScreenCapture::present(screenCapture, mpv, &frameCapture, nullptr);
+        QCoreApplication::processEvents();
+        screenCapture->close();
+
+        /*!
+         * @brief 关闭文件，并执行延迟删除，使采样不受尚未释放的对象影响
+         */
+        before = endings;
+        controller.command({"stop"});
+        await(endings, before);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        ++cycle;
+
+        /*!
+         * @brief 热身结束时记录基线，之后定期采样并检查增长
+         */
+        if (cycle == warmup) {
+            baseline = sampleResources();
+            last = baseline;
+        } else if (cycle > warmup && (cycle - warmup) % sampleEvery == 0) {
+            last = sampleResources();
+            if (baseline.rssKb >= 0 && last.rssKb - baseline.rssKb > maxRssGrowthKb) {
+                exceeded = "rss";
+            } else if (baseline.fds >= 0 && last.fds - baseline.fds > maxFdGrowth) {
+                exceeded = "fds";
+            } else if (baseline.threads >= 0 && last.threads - baseline.threads > maxThreadGrowth) {
+                exceeded = "threads";
+            }
+
+            QJsonObject progress = toJson(last);
+            progress["cycle"] = cycle;
+            progress["elapsed_s"] = clock.elapsed() / 1000;
+            progress["failures"] = failures;
+            std::printf("%s\n", QJsonDocument(progress).toJson(QJsonDocument::Compact).constData());
+            std::fflush(stdout);
+        }
+    }
+
+    delete screenCapture;
+
+    /*!
+     * @brief 汇总结果
+     */
+    QJsonObject result;
+    result["media"] = parser.isSet(mediaOption) ? media : QString("synthetic");
+    result["cycles"] = cycle;
+    result["elapsed_s"] = clock.elapsed() / 1000;
+    result["failures"] = failures;
+    result["baseline"] = toJson(baseline);
+    result["final"] = toJson(last);
+    result["exceeded"] = exceeded;
+    const bool passed = cycle > warmup && failures == 0 && exceeded.isEmpty();
+    result["passed"] = passed;
+
+    std::printf("%s\n", QJsonDocument(result).toJson(QJsonDocument::Compact).constData());
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+#include "synthetic_media.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QTime>
+
+#include "mpv/client.h"
+
+namespace SyntheticMedia {
+
+/*!
+ * @brief 用lavfi生成确定性的测试文件：testsrc2画面（每帧带有时间码）与正弦波音频，
+ * 由MPV的编码模式写成Matroska，固定GOP使关键帧位置在每次生成时都相同
+ */
+bool generate(const QString &path, int duration, QString *error) {
+    mpv_handle *mpv = mpv_create();
+    if (!mpv) {
+        *error = "mpv_create failed";
+        return false;
+    }
+    const QByteArray output = path.toUtf8();
+    mpv_set_option_string(mpv, "o", output.constData());
+    mpv_set_option_string(mpv, "of", "matroska");
+    mpv_set_option_string(mpv, "ovc", "mpeg4");
+    mpv_set_option_string(mpv, "ovcopts", "g=30,bf=0,b=2M");
+    mpv_set_option_string(mpv, "oac", "aac");
+    mpv_set_option_string(mpv, "load-scripts", "no");
+    mpv_set_option_string(mpv, "ytdl", "no");
+    mpv_set_option_string(mpv, "terminal", "no");
+    if (mpv_initialize(mpv) < 0) {
+        mpv_terminate_destroy(mpv);
+        *error = "mpv_initialize failed";
+        return false;
+    }
+
+    const QByteArray source = QString("av://lavfi:testsrc2=size=640x360:rate=30:duration=%1[out0];"
+                                      "sine=frequency=440:sample_rate=48000:duration=%1[out1]")
+            .arg(duration).toUtf8();
+    const char *args[] = {"loadfile", source.constData(), nullptr};
+    if (mpv_command(mpv, args) < 0) {
+        mpv_terminate_destroy(mpv);
+        *error = "loadfile failed";
+        return false;
+    }
+
+    bool completed = false;
+    while (true) {
+        const mpv_event *event = mpv_wait_event(mpv, -1);
+        if (event->event_id == MPV_EVENT_END_FILE) {
+            const auto *endFile = static_cast<const mpv_event_end_file *>(event->data);
+            completed = endFile->reason == MPV_END_FILE_REASON_EOF;
+            if (!completed) {
+                *error = QString("encoding failed: %1").arg(mpv_error_string(endFile->error));
+            }
+            break;
+        }
+        if (event->event_id == MPV_EVENT_SHUTDOWN) {
+            *error = "mpv shut down while encoding";
+            break;
+        }
+    }
+
+    /*!
+     * @brief 销毁实例时才写完容器尾部
+     */
+    mpv_terminate_destroy(mpv);
+    return completed && QFile::exists(path);
+}
+
+/*!
+ * @brief 生成SRT字幕，每两秒一条，label用于区分不同的字幕轨道
+ */
+bool generateSubtitle(const QString &path, int duration, const QString &label) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    const auto timestamp = [](int seconds) {
+        return QTime(0, 0).addSecs(seconds).toString("HH:mm:ss") + ",000";
+    };
+    for (int start = 0, cue = 1; start < duration; start += 2, ++cue) {
+        stream << cue << "\n"
+               << timestamp(start) << " --> " << timestamp(qMin(start + 2, duration)) << "\n"
+               << label << " " << cue << "\n\n";
+    }
+    return stream.status() == QTextStream::Ok;
+}
+
+}
@@ -0,0 +1,17 @@
+#ifndef SYNTHETIC_MEDIA_H
+#define SYNTHETIC_MEDIA_H
+
+#include <QString>
+
+/*!
+ * @brief 基准与压力测试使用的合成媒体，由lavfi现场生成，不依赖外部测试文件
+ */
+namespace SyntheticMedia {
+
+bool generate(const QString &path, int duration, QString *error);
+
+bool generateSubtitle(const QString &path, int duration, const QString &label);
+
+}
+
+#endif //SYNTHETIC_MEDIA_H
@@ -1,16 +1,23 @@
 #include "controller.h"
 #include "application.h"
+#include "thumbnail_provider.h"
 
 Controller::Controller(Application *app, QObject *parent)
-        : QObject(parent), mpv(mpv_create()), application(app), sliderBeingDragged(false), sliderInitialized(false),
-          duration(0.0), zoomFactor(0.0), panX(0.0), panY(0.0), frameRate(0.0) {
+        : QObject(parent), mpv(mpv_create()), application(app), softwareRenderer(nullptr),
+          diagnostics(new Diagnostics(this)), logLevel("info"), eventsScheduled(false), telemetry(nullptr),
+          sliderBeingDragged(false), sliderInitialized(false),
+          duration(0.0), zoomFactor(0.0), panX(0.0), panY(0.0), timePos(0.0), displayedSecond(-1),
+          isPaused(false), isMute(false), volume(80.0), speed(1.0), totalTimeString("00:00:00"),
+          scrubSeekInFlight(false), pendingScrubTarget(-1.0), frameIndexGeneration(0), stepTargetFrame(-1),
+          stepSeekFrame(-1), nextReplyId(1) {
     /*!
      * @brief 根据滑块是否被按下，来判断是否处于拖动滑块状态
      */
-    QSlider *slider = application->getSlider();
+    QSlider *slider = application ? application->getSlider() : nullptr;
     if (slider) {
         connect(slider, &QSlider::sliderPressed, this, &Controller::sliderDragStarted);
         connect(slider, &QSlider::sliderReleased, this, &Controller::sliderDragStopped);
+        connect(slider, &QSlider::sliderMoved, this, &Controller::scrubTo);
     }
 
     /*!
@@ -18,14 +25,14 @@ Controller::Controller(Application *app, QObject *parent)
      */
     if (mpv) {
         /*!
-         * @brief 设置视频输出驱动为OpenGL
+         * @brief 视频由PlayerWidget通过渲染API绘制，视频输出驱动设置为libmpv
          */
-        mpv_set_option_string(mpv, "vo", "opengl");
+        mpv_set_option_string(mpv, "vo", "libmpv");
 
         /*!
-         * @brief 设置音频输出驱动为WASAPI
+         * @brief 设置音频输出驱动为WASAPI，无界面模式下不输出音频
          */
-        mpv_set_option_string(mpv, "ao", "wasapi");
+        mpv_set_option_string(mpv, "ao", isHeadless() ? "null" : "wasapi");
 
         /*!
          * @brief 启用硬件解码
@@ -45,7 +52,7 @@ Controller::Controller(Application *app, QObject *parent)
         /*!
          * @brief 设置初始音量为80
          */
-        setProperty("volume", 80);
+        set<MpvProperty::Volume>(80.0);
 
         /*!
          * @brief 初始化MPV完成后启动它
@@ -54,29 +61,99 @@ Controller::Controller(Application *app, QObject *parent)
             /*!
              * @brief 错误处理
              */
-            QMessageBox::critical(reinterpret_cast<QWidget *>(app), tr("错误"), tr("MPV初始化失败"));
+            if (isHeadless()) {
+                qWarning() << "MPV初始化失败";
+            } else {
+                QMessageBox::critical(reinterpret_cast<QWidget *>(app), tr("错误"), tr("MPV初始化失败"));
+            }
         }
-    }
 
-    /*!
-     * @brief 设置定时器
-     */
-    auto *timer = new QTimer(this);
+        /*!
+         * @brief 注册astra://协议，本地大文件通过内存映射读取，网络存储上的文件通过异步预读读取
+         */
+        LocalStream::registerProtocol(mpv);
 
-    /*!
-     * @brief 每秒更新一次播放进度
-     */
-    connect(timer, &QTimer::timeout, this, &Controller::updateSliderPosition);
+        /*!
+         * @brief 监听播放状态相关属性，属性变化时由MPV主动推送事件，取代定时轮询
+         */
+        mpv_observe_property(mpv, TimePosProperty, "time-pos", MPV_FORMAT_DOUBLE);
+        mpv_observe_property(mpv, DurationProperty, "duration", MPV_FORMAT_DOUBLE);
+        mpv_observe_property(mpv, PauseProperty, "pause", MPV_FORMAT_FLAG);
+        mpv_observe_property(mpv, MuteProperty, "mute", MPV_FORMAT_FLAG);
+        mpv_observe_property(mpv, VolumeProperty, "volume", MPV_FORMAT_DOUBLE);
+        mpv_observe_property(mpv, SpeedProperty, "speed", MPV_FORMAT_DOUBLE);
+        mpv_observe_property(mpv, TrackListProperty, "track-list", MPV_FORMAT_NODE);
 
-    /*!
-     * @brief 检测视频时长变化，应对在线视频在开始播放时，可能并未完全加载，其总时长未知的情形
-     */
-    connect(timer, &QTimer::timeout, this, &Controller::updateSliderDuration);
-    timer->start(1000);
+        /*!
+         * @brief 连续的相对调整按通道合并，跳转在画面重新开始播放后才算完成
+         */
+        inputCoalescer.addChannel("seek", [this](double amount) {
+            if (telemetry) {
+                telemetry->seekStarted();
+            }
+            commandAsync({"seek", QString::number(amount), "relative"}, [this](int error, const QVariant &) {
+                if (error < 0) {
+                    inputCoalescer.complete("seek");
+                }
+            });
+        });
+        for (const char *name: {"volume", "speed", "video-zoom", "video-pan-x", "video-pan-y", "audio-delay"}) {
+            addPropertyChannel(name);
+        }
+
+        /*!
+         * @brief 事件在专用线程中取出，每批事件只向主线程投递一次处理
+         */
+        eventThread = std::make_unique<MpvEventThread>(mpv, [this]() {
+            if (!eventsScheduled.exchange(true)) {
+                QMetaObject::invokeMethod(this, &Controller::handleMpvEvents, Qt::QueuedConnection);
+            }
+        });
+        eventThread->setLogHandler([this](const mpv_event_log_message *message) {
+            mpvLog.append(message);
+        });
+        eventThread->start();
+
+        /*!
+         * @brief 日志写入有界缓冲区，由日志窗口按需读取
+         */
+        setLogLevel(logLevel);
+
+        /*!
+         * @brief 记录每次播放的首帧时间、缓冲中断、丢帧与跳转延迟；
+         * 无界面模式用于基准与压力测试，不写入用户的播放统计
+         */
+        if (!isHeadless()) {
+            telemetry = new SessionTelemetry(this);
+        }
+    }
 }
 
 Controller::~Controller() {
+    /*!
+     * @brief 中止帧索引的建立并等待后台线程退出，线程完成时会回调本对象
+     */
+    resetFrameIndex();
+    for (QThread *builder: findChildren<QThread *>(QString(), Qt::FindDirectChildrenOnly)) {
+        builder->wait();
+    }
+
     if (mpv) {
+        /*!
+         * @brief 先停止事件线程，mpv_wait_event不能与mpv_terminate_destroy并发
+         */
+        eventThread.reset();
+
+        /*!
+         * @brief 渲染上下文必须先于MPV实例释放
+         */
+        if (playerWidget) {
+            playerWidget->releaseRenderContext();
+        }
+        if (softwareRenderer) {
+            softwareRenderer->release();
+        }
+
         /*!
          * @brief 清理MPV资源
          */
@@ -85,28 +162,205 @@ Controller::~Controller() {
 }
 
 /*!
- * @brief 将MPV的视频输出绑定到QWidget上
+ * @brief 在主线程中处理事件线程送来的一批事件
+ */
+void Controller::handleMpvEvents() {
+    eventsScheduled = false;
+
+    MpvEvent event;
+    while (eventThread && eventThread->pop(event)) {
+        TRACE_SCOPE("mpv event", "controller", mpv_event_name(event.id));
+        switch (event.id) {
+            case MPV_EVENT_PROPERTY_CHANGE:
+                handlePropertyChange(event);
+                break;
+            case MPV_EVENT_COMMAND_REPLY:
+            case MPV_EVENT_SET_PROPERTY_REPLY:
+                handleReply(event);
+                break;
+            case MPV_EVENT_FILE_LOADED:
+                buildFrameIndex();
+                emit fileLoaded();
+                break;
+            case MPV_EVENT_PLAYBACK_RESTART:
+                finishScrubSeek();
+                finishFrameStep();
+                inputCoalescer.complete("seek");
+                emit playbackRestarted();
+                break;
+            case MPV_EVENT_END_FILE:
+                finishScrubSeek();
+                inputCoalescer.complete("seek");
+                emit fileEnded(static_cast<int>(event.integer));
+                break;
+            default:
+                break;
+        }
+        delete event.node;
+    }
+}
+
+/*!
+ * @brief 根据reply_userdata找到异步请求对应的回调并执行
+ */
+void Controller::handleReply(const MpvEvent &event) {
+    TRACE_FUNCTION("controller");
+
+    ReplyCallback callback = pendingReplies.take(event.replyUserdata);
+
+    /*!
+     * @brief 未提供回调的请求在出错时统一提示
+     */
+    if (callback) {
+        callback(event.error, event.node ? *event.node : QVariant());
+    } else if (event.error < 0) {
+        reportError(event.id == MPV_EVENT_COMMAND_REPLY ? "MPV命令错误：" : "MPV设置参数错误：", event.error);
+    }
+}
+
+/*!
+ * @brief 处理监听属性的变化，仅在数值确实改变时更新界面
+ */
+void Controller::handlePropertyChange(const MpvEvent &event) {
+    TRACE_FUNCTION("controller");
+
+    /*!
+     * @brief 属性不可用（如尚未加载文件）时格式为MPV_FORMAT_NONE
+     */
+    const bool available = event.format != MPV_FORMAT_NONE;
+
+    switch (event.replyUserdata) {
+        case TimePosProperty:
+            updateSliderPosition(available ? event.number : 0.0);
+            break;
+        case DurationProperty:
+            updateSliderDuration(available ? event.number : 0.0);
+            emit durationChanged(available ? event.number : 0.0);
+            break;
+        case PauseProperty:
+            if (available) {
+                isPaused = event.integer != 0;
+                if (sliderInitialized && !isHeadless()) {
+                    updateTimeLabel();
+                }
+                emit pauseChanged(isPaused);
+            }
+            break;
+        case MuteProperty:
+            if (available) {
+                isMute = event.integer != 0;
+                emit muteChanged(isMute);
+            }
+            break;
+        case VolumeProperty:
+            if (available) {
+                volume = event.number;
+                emit volumeChanged(static_cast<int>(volume));
+            }
+            break;
+        case SpeedProperty:
+            if (available) {
+                speed = event.number;
+                emit speedChanged(speed);
+            }
+            break;
+        case TrackListProperty:
+            trackList = available && event.node ? event.node->toList() : QVariantList();
+            emit trackListChanged();
+            break;
+        default:
+            emit observedPropertyChanged(event);
+            break;
+    }
+}
+
+/*!
+ * @brief 将MPV的视频输出绑定到PlayerWidget上
  */
-void Controller::setPlayerWidget(QWidget *widget) {
+void Controller::setPlayerWidget(PlayerWidget *widget) {
+    TRACE_FUNCTION("controller");
+
     if (widget == nullptr) {  // 检查widget是否为空
         QMessageBox::critical(reinterpret_cast<QWidget *>(application), tr("错误"), tr("Widget为空无法绑定！"));
         return;
     }
-    mpv_set_option_string(mpv, "wid", QString::number(widget->winId()).toUtf8().constData());
+    playerWidget = widget;
+    playerWidget->setMpvInstance(mpv);
+}
+
+/*!
+ * @brief 无界面模式下将视频渲染到调用方持有的内存缓冲区，缓冲区需在渲染期间保持有效
+ */
+SoftwareRenderer *Controller::setSoftwareRenderTarget(void *buffer, int width, int height, size_t stride) {
+    TRACE_FUNCTION("controller");
+
+    if (!softwareRenderer) {
+        softwareRenderer = new SoftwareRenderer(mpv, this);
+    }
+    if (!softwareRenderer->setTarget(buffer, width, height, stride)) {
+        return nullptr;
+    }
+    return softwareRenderer;
+}
+
+/*!
+ * @brief 返回当前打开的文件路径或URL（未经astra://改写）
+ */
+const QString &Controller::getCurrentFile() const {
+    return currentFile;
+}
+
+/*!
+ * @brief 是否以无界面模式运行
+ */
+bool Controller::isHeadless() const {
+    return application == nullptr;
+}
+
+/*!
+ * @brief 返回监听得到的当前播放位置（秒）
+ */
+double Controller::getTimePos() const {
+    return timePos;
+}
+
+/*!
+ * @brief 返回监听得到的总时长（秒）
+ */
+double Controller::getDuration() const {
+    return duration;
 }
 
 /*!
  * @brief 打开文件
  */
 void Controller::openFile(const QString &filename) {
-    QStringList args = {"loadfile", filename};
-    command(args);
+    TRACE_FUNCTION("controller");
+
+    /*!
+     * @brief 异步加载文件，避免网络流或慢速存储阻塞界面
+     */
+    currentFile = filename;
+    QString uri = filename;
+    if (LocalStream::isSuitable(filename)) {
+        uri = LocalStream::toUri(filename);
+    }
+    if (telemetry) {
+        telemetry->beginSession(filename);
+    }
+
+    QStringList args = {"loadfile", uri};
+    commandAsync(args);
+
+    /*!
+     * @brief 上一个文件的帧索引与积压的调整不再适用
+     */
+    resetFrameIndex();
+    inputCoalescer.reset();
 
     /*!
      * @brief 确保播放状态正确
      */
-    QVariant pauseValue = getProperty("pause");
-    const bool isPaused = pauseValue.toBool();
     if (isPaused) {
         Controller::togglePlayPause();
     }
@@ -120,25 +374,27 @@ void Controller::openFile(const QString &filename) {
      * @brief 更新进度条初始化状态
      */
     sliderInitialized = true;
-
-    /*!
-     * @brief 切换播放图标到正在播放状态
-     */
-    application->updatePlayIcon(true);
 }
 
 /*!
  * @brief 打开URL
  */
 void Controller::handleUrl(const QString &url) {
+    TRACE_FUNCTION("controller");
+
+    currentFile = url;
+    if (telemetry) {
+        telemetry->beginSession(url);
+    }
     QStringList args = {"loadfile", url};
-    command(args);
+    commandAsync(args);
+
+    resetFrameIndex();
+    inputCoalescer.reset();
 
     /*!
      * @brief 确保播放状态正确
      */
-    QVariant pauseValue = getProperty("pause");
-    const bool isPaused = pauseValue.toBool();
     if (isPaused) {
         Controller::togglePlayPause();
     }
@@ -152,46 +408,50 @@ void Controller::handleUrl(const QString &url) {
      * @brief 更新进度条初始化状态
      */
     sliderInitialized = true;
-
-    /*!
-     * @brief 切换播放图标到正在播放状态
-     */
-    application->updatePlayIcon(true);
 }
 
 /*!
  * @brief 初始化滑块的总时长
  */
 void Controller::initializeSliderDuration() {
-    duration = Controller::getProperty("duration").toDouble();
-    if (mpv) {
-        if (duration > 0) {
-            /*!
-             * @brief 设置滑块的最大值为视频总时长（秒）
-             */
-            QSlider *slider = application->getSlider();
-            slider->setMaximum(static_cast<int>(duration));
-        }
+    TRACE_FUNCTION("controller");
+
+    /*!
+     * @brief loadfile为异步加载，此时总时长尚不可知，先复位滑块，待duration属性推送后再更新
+     */
+    duration = 0.0;
+    timePos = 0.0;
+    displayedSecond = -1;
+    totalTimeString = formatTime(duration);
+
+    if (isHeadless()) {
+        return;
     }
 
+    QSlider *slider = application->getSlider();
+    slider->setMaximum(0);
+    slider->setValue(0);
+
     /*!
      * @brief 设置时间显示
      */
-    totalTime = QTime((int) (duration / 3600) % 60, (int) (duration / 60) % 60, (int) duration % 60);
-    QString timeString = "00:00:00/" + totalTime.toString("hh:mm:ss");
-    application->timeLabel->setText(timeString);
+    updateTimeLabel();
 }
 
 /*!
  * @brief 应对在线视频在开始播放时，可能并未完全加载，其总时长未知需要缓冲后更新的情况
  */
-void Controller::updateSliderDuration() {
-    double newDuration = Controller::getProperty("duration").toDouble();
+void Controller::updateSliderDuration(double newDuration) {
+    TRACE_FUNCTION("controller");
+
     if (newDuration != duration) {
         /*!
          * @brief 更新视频总时长值
          */
         duration = newDuration;
+        if (isHeadless()) {
+            return;
+        }
 
         /*!
          * @brief 设置滑块的最大值为视频总时长（秒）
@@ -202,57 +462,96 @@ void Controller::updateSliderDuration() {
         /*!
          * @brief 更新时间显示
          */
-        int64_t time;
-        mpv_get_property(mpv, "time-pos", MPV_FORMAT_INT64, &time);
-        QTime currentTime((int) (time / 3600) % 60, (int) (time / 60) % 60, (int) time % 60);
-        totalTime = QTime((int) (newDuration / 3600) % 60, (int) (newDuration / 60) % 60, (int) newDuration % 60);
-        QString timeString = currentTime.toString("hh:mm:ss") + "/" + totalTime.toString("hh:mm:ss");
-        application->timeLabel->setText(timeString);
+        totalTimeString = formatTime(duration);
+        updateTimeLabel();
     }
 }
 
 /*!
  * @brief 播放时更新滑块位置
  */
-void Controller::updateSliderPosition() {
+void Controller::updateSliderPosition(double time) {
+    TRACE_FUNCTION("controller");
+
+    timePos = time;
+
     /*!
-     * @brief 当MPV实例已完成初始化，播放进度滑块不处于拖动状态，滑块已初始化的情况下才更新滑块位置
+     * @brief 画面离开了逐帧后退停留的帧（继续播放等），之后的后退重新从播放位置计算
      */
-    if (mpv && !sliderBeingDragged && sliderInitialized) {
-        /*!
-         * @brief 获取当前播放时间
-         */
-        int64_t time;
-        mpv_get_property(mpv, "time-pos", MPV_FORMAT_INT64, &time);
+    if (stepSeekFrame < 0 && stepTargetFrame >= 0 &&
+        (!frameIndex || frameIndex->frameAt(time) != stepTargetFrame)) {
+        stepTargetFrame = -1;
+    }
 
+    /*!
+     * @brief 滑块与时间显示精确到秒，秒数未变化时不刷新界面
+     */
+    const int second = static_cast<int>(time);
+    if (!sliderInitialized || isHeadless()) {
+        return;
+    }
+    if (second == displayedSecond) {
         /*!
-         * @brief 设置滑块的位置
+         * @brief 暂停时逐帧移动通常不跨秒，但帧号需要刷新
          */
+        if (isPaused && frameIndex) {
+            updateTimeLabel();
+        }
+        return;
+    }
+    displayedSecond = second;
+
+    /*!
+     * @brief 播放进度滑块不处于拖动状态时才更新滑块位置
+     */
+    if (!sliderBeingDragged) {
         QSlider *slider = application->getSlider();
-        if (slider) { slider->setValue(static_cast<int>(time)); }
+        if (slider) { slider->setValue(second); }
+    }
 
-        /*!
-         * @brief 更新时间显示
-         */
-        QTime currentTime((int) (time / 3600) % 60, (int) (time / 60) % 60, (int) time % 60);
-        QString timeString = currentTime.toString("hh:mm:ss") + "/" + totalTime.toString("hh:mm:ss");
-        application->timeLabel->setText(timeString);
-    } else if (mpv && sliderInitialized) {// 当MPV实例已完成初始化，滑块已初始化的情况下继续更新时间显示
-        /*!
-         * @brief 更新时间显示
-         */
-        int64_t time;
-        mpv_get_property(mpv, "time-pos", MPV_FORMAT_INT64, &time);
-        QTime currentTime((int) (time / 3600) % 60, (int) (time / 60) % 60, (int) time % 60);
-        QString timeString = currentTime.toString("hh:mm:ss") + "/" + totalTime.toString("hh:mm:ss");
-        application->timeLabel->setText(timeString);
+    /*!
+     * @brief 拖动过程中继续更新时间显示
+     */
+    updateTimeLabel();
+}
+
+/*!
+ * @brief 更新时间显示
+ */
+void Controller::updateTimeLabel() {
+    TRACE_FUNCTION("controller");
+
+    QString text = formatTime(displayedSecond < 0 ? 0 : displayedSecond) + "/" + totalTimeString;
+
+    /*!
+     * @brief 暂停且帧索引可用时附加当前帧号
+     */
+    if (isPaused && frameIndex) {
+        const int frame = frameIndex->frameAt(timePos);
+        if (frame >= 0) {
+            text += tr("  帧 %1/%2").arg(frame + 1).arg(frameIndex->frameCount());
+            if (frameIndex->isKeyframe(frame)) {
+                text += tr(" 关键帧");
+            }
+        }
     }
+    application->timeLabel->setText(text);
+}
+
+/*!
+ * @brief 将秒数格式化为hh:mm:ss
+ */
+QString Controller::formatTime(double seconds) {
+    QTime time((int) (seconds / 3600) % 60, (int) (seconds / 60) % 60, (int) seconds % 60);
+    return time.toString("hh:mm:ss");
 }
 
 /*!
  * @brief 开始拖动播放进度滑块，更新状态
  */
 void Controller::sliderDragStarted() {
+    TRACE_FUNCTION("controller");
+
     sliderBeingDragged = true;
 }
 
@@ -260,16 +559,79 @@ void Controller::sliderDragStarted() {
  * @brief 结束拖动播放进度滑块，更新状态
  */
 void Controller::sliderDragStopped() {
+    TRACE_FUNCTION("controller");
+
     sliderBeingDragged = false;
+
+    /*!
+     * @brief 松开后由精确跳转决定最终位置，尚未发出的预览跳转不再需要
+     */
+    pendingScrubTarget = -1.0;
+}
+
+/*!
+ * @brief 拖动滑块时跳转到最近的关键帧以便实时预览画面
+ */
+void Controller::scrubTo(int seconds) {
+    TRACE_FUNCTION("controller");
+
+    /*!
+     * @brief 同一时间只有一个预览跳转在进行，期间的拖动只保留最新位置，待其完成后再发出
+     */
+    if (scrubSeekInFlight) {
+        pendingScrubTarget = seconds;
+        return;
+    }
+
+    scrubSeekInFlight = true;
+    cancelFrameStep();
+    if (telemetry) {
+        telemetry->seekStarted();
+    }
+    commandAsync({"seek", QString::number(seconds), "absolute+keyframes"}, [this](int error, const QVariant &) {
+        if (error < 0) {
+            finishScrubSeek();
+        }
+    });
+}
+
+/*!
+ * @brief 注册通过add命令调整属性的合并通道，add由MPV在属性当前值上累加并自行限制范围
+ */
+void Controller::addPropertyChannel(const QString &name) {
+    inputCoalescer.addChannel(name, [this, name](double amount) {
+        commandAsync({"add", name, QString::number(amount)}, [this, name](int error, const QVariant &) {
+            inputCoalescer.complete(name);
+            if (error < 0) {
+                reportError("MPV设置参数错误：", error);
+            }
+        });
+    });
+}
+
+/*!
+ * @brief 预览跳转完成（或失败），发出拖动期间积压的最新位置
+ */
+void Controller::finishScrubSeek() {
+    TRACE_FUNCTION("controller");
+
+    scrubSeekInFlight = false;
+    if (pendingScrubTarget >= 0.0) {
+        const int target = static_cast<int>(pendingScrubTarget);
+        pendingScrubTarget = -1.0;
+        scrubTo(target);
+    }
 }
 
 /*!
  * @brief 放大视频10%
  */
 void Controller::zoomIn() {
-    zoomFactor += 0.1;
-    if (zoomFactor < 3.0) {
-        setProperty("video-zoom", zoomFactor);
+    TRACE_FUNCTION("controller");
+
+    if (zoomFactor + 0.1 < 3.0) {
+        zoomFactor += 0.1;
+        inputCoalescer.add("video-zoom", 0.1);
     }
 }
 
@@ -277,9 +639,11 @@ void Controller::zoomIn() {
  * @brief 缩小视频10%
  */
 void Controller::zoomOut() {
-    zoomFactor -= 0.1;
-    if (zoomFactor > -3.0) {
-        setProperty("video-zoom", zoomFactor);
+    TRACE_FUNCTION("controller");
+
+    if (zoomFactor - 0.1 > -3.0) {
+        zoomFactor -= 0.1;
+        inputCoalescer.add("video-zoom", -0.1);
     }
 }
 
@@ -287,61 +651,83 @@ void Controller::zoomOut() {
  * @brief 重置视频缩放
  */
 void Controller::zoomReset() {
+    TRACE_FUNCTION("controller");
+
     zoomFactor = 0.0;
-    setProperty("video-zoom", 0.0);
+    inputCoalescer.discard("video-zoom");
+    setAsync<MpvProperty::VideoZoom>(0.0);
 }
 
 /*!
  * @brief 视频位置控制
  */
 void Controller::moveLeft() {
+    TRACE_FUNCTION("controller");
+
     panX -= 0.1;
-    setProperty("video-pan-x", panX);
+    inputCoalescer.add("video-pan-x", -0.1);
 }
 
 void Controller::moveRight() {
+    TRACE_FUNCTION("controller");
+
     panX += 0.1;
-    setProperty("video-pan-x", panX);
+    inputCoalescer.add("video-pan-x", 0.1);
 }
 
 void Controller::moveUp() {
+    TRACE_FUNCTION("controller");
+
     panY -= 0.1;
-    setProperty("video-pan-y", panY);
+    inputCoalescer.add("video-pan-y", -0.1);
 }
 
 void Controller::moveDown() {
+    TRACE_FUNCTION("controller");
+
     panY += 0.1;
-    setProperty("video-pan-y", panY);
+    inputCoalescer.add("video-pan-y", 0.1);
 }
 
 void Controller::moveReset() {
+    TRACE_FUNCTION("controller");
+
     panX = 0.0;
     panY = 0.0;
-    setProperty("video-pan-x", panX);
-    setProperty("video-pan-y", panY);
+    inputCoalescer.discard("video-pan-x");
+    inputCoalescer.discard("video-pan-y");
+    setAsync<MpvProperty::VideoPanX>(panX);
+    setAsync<MpvProperty::VideoPanY>(panY);
 }
 
 /*!
- * @brief 跳转到指定播放位置
+ * @brief 精确跳转到指定播放位置，用于松开进度滑块等需要准确定位的场合
  */
 void Controller::seek(int seconds) {
-    QStringList args = {"seek", QString::number(seconds), "absolute"};
-    command(args);
+    TRACE_FUNCTION("controller");
+
+    pendingScrubTarget = -1.0;
+    cancelFrameStep();
+    if (telemetry) {
+        telemetry->seekStarted();
+    }
+    QStringList args = {"seek", QString::number(seconds), "absolute+exact"};
+    commandAsync(args);
 }
 
 /*!
  * @brief 跳转到相对播放位置
  */
 void Controller::seekRelative(int seconds) {
+    TRACE_FUNCTION("controller");
+
     /*!
-     * @brief 添加判断防止跳转越界
+     * @brief 添加判断防止跳转越界，播放位置取自监听缓存并计入尚未完成的跳转
      */
-    QVariant QTime = getProperty("time-pos");
-    const double time = QTime.toDouble();
-
-    if ((time + seconds <= duration) && (time + seconds >= 0.0)) {
-        QStringList args = {"seek", QString::number(seconds), "relative"};
-        command(args);
+    const double target = timePos + inputCoalescer.pending("seek") + seconds;
+    if ((target <= duration) && (target >= 0.0)) {
+        cancelFrameStep();
+        inputCoalescer.add("seek", seconds);
     }
 }
 
@@ -349,57 +735,40 @@ void Controller::seekRelative(int seconds) {
  * @brief 切换播放暂停
  */
 void Controller::togglePlayPause() {
-    /*!
-     * @brief 获取当前的暂停状态
-     */
-    QVariant pauseValue = getProperty("pause");
-
-    /*!
-     * @brief 切换播放/暂停状态
-     */
-    const bool isPaused = pauseValue.toBool();
-    setProperty("pause", !isPaused);
+    TRACE_FUNCTION("controller");
 
     /*!
-     * @brief 切换对应状态图标
+     * @brief 切换播放/暂停状态，状态图标由pauseChanged信号更新
      */
-    application->updatePlayIcon(isPaused);
+    set<MpvProperty::Pause>(!isPaused);
 }
 
 /*!
  * @brief 播放视频
  */
 void Controller::playVideo() {
-    setProperty("pause", false);
+    TRACE_FUNCTION("controller");
 
-    /*!
-     * @brief 切换播放图标
-     */
-    application->updatePlayIcon(true);
+    set<MpvProperty::Pause>(false);
 }
 
 /*!
  * @brief 设置播放音量
  */
 void Controller::setVolume(int volume, bool flag) {
-    if (flag) {
-        /*!
-         * @brief 获取当前音量
-         */
-        QVariant QCurrentVolumeValue = getProperty("volume");
-        const int currentVolumeValue = QCurrentVolumeValue.toInt();
+    TRACE_FUNCTION("controller");
 
+    if (flag) {
         /*!
-         * @brief 设置相对音量
+         * @brief 设置相对音量，音量滑块由volumeChanged信号更新
          */
-        setProperty("volume", currentVolumeValue + volume);
-
-        application->volumeAction->updateVolumeSlider(currentVolumeValue + volume);
+        inputCoalescer.add("volume", volume);
     } else {
         /*!
-         * @brief 设置绝对音量
+         * @brief 设置绝对音量，取代尚未发出的相对调整
          */
-        setProperty("volume", volume);
+        inputCoalescer.discard("volume");
+        set<MpvProperty::Volume>(volume);
     }
 }
 
@@ -407,39 +776,27 @@ void Controller::setVolume(int volume, bool flag) {
  * @brief 切换静音状态
  */
 void Controller::toggleMute() {
-    /*!
-     * @brief 获取当前的静音状态
-     */
-    QVariant muteValue = getProperty("mute");
-
-    /*!
-     * @brief 切换静音状态
-     */
-    const bool isMute = muteValue.toBool();
-    setProperty("mute", !isMute);
-
-    /*!
-     * @brief 切换对应状态图标
-     */
-    application->updateVolumeIcon(!isMute);
+    TRACE_FUNCTION("controller");
 
     /*!
-     * @brief 切换对应勾选状态
+     * @brief 切换静音状态，状态图标与勾选状态由muteChanged信号更新
      */
-    application->ui->muteAudio->setChecked(!isMute);
+    set<MpvProperty::Mute>(!isMute);
 }
 
 /*!
  * @brief 设置播放速度
  */
 void Controller::setSpeed(double speed) {
-    QVariant qCurrentSpeed = getProperty("speed");
-    double const currentSpeed = qCurrentSpeed.toDouble();
+    TRACE_FUNCTION("controller");
+
+    double const currentSpeed = this->speed + inputCoalescer.pending("speed");
 
     if (currentSpeed + speed <= 10 && currentSpeed + speed >= 0 && speed != 0) {
-        setProperty("speed", currentSpeed + speed);
+        inputCoalescer.add("speed", speed);
     } else if (speed == 0) {
-        setProperty("speed", 1.0);
+        inputCoalescer.discard("speed");
+        set<MpvProperty::Speed>(1.0);
     }
 }
 
@@ -447,112 +804,202 @@ void Controller::setSpeed(double speed) {
  * @brief 设置播放速度倍数
  */
 void Controller::setSpeedMultiple(double multiple) {
-    QVariant qCurrentSpeed = getProperty("speed");
-    double const currentSpeed = qCurrentSpeed.toDouble();
+    TRACE_FUNCTION("controller");
+
+    inputCoalescer.discard("speed");
+    double const currentSpeed = speed;
 
     /*!
      * @brief 暂停状态下按L键开始默认速度播放，非暂停状态下倍速播放
      */
     if (multiple == 2) {
-        /*!
-         * @brief 获取当前的暂停状态
-         */
-        QVariant pauseValue = getProperty("pause");
-        const bool isPaused = pauseValue.toBool();
-
         if (isPaused) {
-            setProperty("speed", 1.0);
+            set<MpvProperty::Speed>(1.0);
             return;
         } else {
-            setProperty("speed", currentSpeed * multiple);
+            set<MpvProperty::Speed>(currentSpeed * multiple);
             return;
         }
     }
 
-    setProperty("speed", currentSpeed * multiple);
+    set<MpvProperty::Speed>(currentSpeed * multiple);
 }
 
 /*!
  * @brief 调整音频同步
  */
 void Controller::adjustAudio(double sec) {
-    /*!
-     * @brief 获取当前音频延迟
-     */
-    QVariant QCurrentDelay = getProperty("audio-delay");
-    double currentDelay = QCurrentDelay.toDouble();
+    TRACE_FUNCTION("controller");
 
     /*!
-     * @brief 调整音频延迟
+     * @brief 由MPV在当前音频延迟上累加，无需先同步读取
      */
-    setProperty("audio-delay", currentDelay + sec);
+    inputCoalescer.add("audio-delay", sec);
 }
 
 /*!
  * @brief 重置音频同步设置
  */
 void Controller::resetAudioSync() {
-    setProperty("audio-delay", 0);
-}
+    TRACE_FUNCTION("controller");
 
-/*!
- * @brief 获取视频帧率（对某些文件并非完全可靠）
- */
-void Controller::getFrameRate() {
-    QVariant QFrameRate = getProperty("container-fps");
-    frameRate = QFrameRate.toDouble();
+    inputCoalescer.discard("audio-delay");
+    set<MpvProperty::AudioDelay>(0.0);
 }
 
 /*!
  * @brief 跳转到上一帧
  */
 void Controller::goToPreviousFrame() {
-    /*!
-     * @brief 获取当前播放位置
-     */
-    QVariant QPosition = getProperty("time-pos");
-    double position = QPosition.toDouble();
+    TRACE_FUNCTION("controller");
 
     /*!
-     * @brief 获取该视频帧率
+     * @brief 帧索引可用时精确跳转到上一帧的时间戳，对可变帧率的文件同样准确；
+     * 否则交给MPV的frame-back-step，由其从前一个关键帧解码到目标帧
      */
-    getFrameRate();
+    if (frameIndex) {
+        /*!
+         * @brief 从上一次后退的目标帧继续计算，不依赖尚未更新的播放位置，连按时每次都会生效
+         */
+        const int frame = stepTargetFrame >= 0 ? stepTargetFrame : frameIndex->frameAt(timePos);
+        if (frame > 0) {
+            if (!isPaused) {
+                setAsync<MpvProperty::Pause>(true);
+            }
+            stepTargetFrame = frame - 1;
 
-    /*!
-     * @brief 设置新的播放位置
-     */
-    setProperty("time-pos", position - 1.0 / frameRate);
+            /*!
+             * @brief 同一时间只有一个跳转在进行，期间的连按只移动目标帧，完成后一次跳到最新的目标
+             */
+            if (stepSeekFrame < 0) {
+                seekToFrame(stepTargetFrame);
+            }
+            return;
+        }
+        if (frame == 0) {
+            return;
+        }
+    }
+    commandAsync({"frame-back-step"});
+}
+
+/*!
+ * @brief 精确跳转到索引中的某一帧
+ */
+void Controller::seekToFrame(int frame) {
+    TRACE_FUNCTION("controller");
+
+    stepSeekFrame = frame;
+    commandAsync({"seek", QString::number(frameIndex->timeOf(frame), 'f', 6), "absolute+exact"},
+                 [this, frame](int error, const QVariant &) {
+                     if (error < 0 && stepSeekFrame == frame) {
+                         cancelFrameStep();
+                     }
+                 });
+}
+
+/*!
+ * @brief 逐帧后退的跳转完成，期间目标帧又有变化时继续跳转
+ */
+void Controller::finishFrameStep() {
+    TRACE_FUNCTION("controller");
+
+    if (stepSeekFrame < 0) {
+        return;
+    }
+    if (frameIndex && stepTargetFrame >= 0 && stepTargetFrame != stepSeekFrame) {
+        seekToFrame(stepTargetFrame);
+        return;
+    }
+    stepSeekFrame = -1;
+}
+
+/*!
+ * @brief 其他跳转会改变播放位置，放弃逐帧后退的目标
+ */
+void Controller::cancelFrameStep() {
+    stepTargetFrame = -1;
+    stepSeekFrame = -1;
 }
 
 /*!
  * @brief 跳转到下一帧
  */
 void Controller::goToNextFrame() {
-    /*!
-     * @brief 获取当前播放位置
-     */
-    QVariant QPosition = getProperty("time-pos");
-    double position = QPosition.toDouble();
+    TRACE_FUNCTION("controller");
 
     /*!
-     * @brief 获取该视频帧率
+     * @brief frame-step只需再解码一帧，不触发跳转，并会自动暂停
      */
-    getFrameRate();
+    cancelFrameStep();
+    commandAsync({"frame-step"});
+}
+
+/*!
+ * @brief 中止正在建立的帧索引并丢弃当前索引
+ */
+void Controller::resetFrameIndex() {
+    TRACE_FUNCTION("controller");
+
+    if (frameIndexAborted) {
+        *frameIndexAborted = true;
+        frameIndexAborted.reset();
+    }
+    frameIndex.reset();
+    cancelFrameStep();
+    ++frameIndexGeneration;
+}
+
+/*!
+ * @brief 文件加载完成后在后台读取或建立帧索引，完成前逐帧操作退回MPV的内置实现
+ */
+void Controller::buildFrameIndex() {
+    TRACE_FUNCTION("controller");
 
     /*!
-     * @brief 设置新的播放位置
+     * @brief 同一文件只建立一次，无界面模式与网络流不建立
      */
-    setProperty("time-pos", position + 1.0 / frameRate);
+    if (frameIndexAborted || isHeadless() || !ThumbnailProvider::isSupported(currentFile)) {
+        return;
+    }
+
+    auto aborted = std::make_shared<std::atomic<bool>>(false);
+    frameIndexAborted = aborted;
+    const QString path = currentFile;
+    const int generation = frameIndexGeneration;
+    QThread *builder = QThread::create([this, path, aborted, generation]() {
+        QSharedPointer<const FrameIndex> index = FrameIndex::load(path);
+        if (!index) {
+            index = FrameIndex::build(path, *aborted);
+        }
+        if (!index || *aborted) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, index, generation]() {
+            if (generation != frameIndexGeneration) {
+                return;
+            }
+            frameIndex = index;
+            if (isPaused && sliderInitialized) {
+                updateTimeLabel();
+            }
+        }, Qt::QueuedConnection);
+    });
+    builder->setParent(this);
+    connect(builder, &QThread::finished, builder, &QObject::deleteLater);
+    builder->start(QThread::LowestPriority);
 }
 
 /*!
  * @brief 发送命令到MPV
  */
 void Controller::command(const QStringList &args) {
+    const QByteArray traceDetail = Trace::isEnabled() ? args.value(0).toUtf8() : QByteArray();
+    TRACE_SCOPE("mpv_command_node", "mpv", traceDetail.constData());
+
     auto result = mpv::qt::command(mpv, args);
     if (mpv::qt::is_error(result)) {
-        QMessageBox::critical(reinterpret_cast<QWidget *>(application), tr("错误"),
-                              "MPV命令错误：" + QString::number(mpv::qt::get_error(result)));
+        reportError("MPV命令错误：", mpv::qt::get_error(result));
     }
 }
 
@@ -560,10 +1007,59 @@ void Controller::command(const QStringList &args) {
  * @brief MPV属性设置函数
  */
 void Controller::setProperty(const QString &name, const QVariant &value) {
+    const QByteArray traceDetail = Trace::isEnabled() ? name.toUtf8() : QByteArray();
+    TRACE_SCOPE("mpv_set_property", "mpv", traceDetail.constData());
+
     auto result = mpv::qt::set_property(mpv, name, value);
     if (mpv::qt::is_error(result)) {
-        QMessageBox::critical(reinterpret_cast<QWidget *>(application), tr("错误"),
-                              "MPV设置参数错误：" + QString::number(mpv::qt::get_error(result)));
+        reportError("MPV设置参数错误：", mpv::qt::get_error(result));
+    }
+}
+
+/*!
+ * @brief 异步发送命令到MPV，命令完成后在主线程中执行回调
+ */
+void Controller::commandAsync(const QStringList &args, const ReplyCallback &callback) {
+    const QByteArray traceDetail = Trace::isEnabled() ? args.value(0).toUtf8() : QByteArray();
+    TRACE_SCOPE("mpv_command_node_async", "mpv", traceDetail.constData());
+
+    const uint64_t replyId = nextReplyId++;
+    pendingReplies.insert(replyId, callback);
+
+    mpv::qt::node_builder node(args);
+    int error = mpv_command_node_async(mpv, replyId, node.node());
+    if (error < 0) {
+        /*!
+         * @brief 命令未能提交时不会有回复事件，直接在此处完成回调
+         */
+        pendingReplies.remove(replyId);
+        if (callback) {
+            callback(error, QVariant());
+        } else {
+            reportError("MPV命令错误：", error);
+        }
+    }
+}
+
+/*!
+ * @brief 异步设置MPV属性，设置完成后在主线程中执行回调
+ */
+void Controller::setPropertyAsync(const QString &name, const QVariant &value, const ReplyCallback &callback) {
+    const QByteArray traceDetail = Trace::isEnabled() ? name.toUtf8() : QByteArray();
+    TRACE_SCOPE("mpv_set_property_async", "mpv", traceDetail.constData());
+
+    const uint64_t replyId = nextReplyId++;
+    pendingReplies.insert(replyId, callback);
+
+    mpv::qt::node_builder node(value);
+    int error = mpv_set_property_async(mpv, replyId, name.toUtf8().constData(), MPV_FORMAT_NODE, node.node());
+    if (error < 0) {
+        pendingReplies.remove(replyId);
+        if (callback) {
+            callback(error, QVariant());
+        } else {
+            reportError("MPV设置参数错误：", error);
+        }
     }
 }
 
@@ -571,15 +1067,68 @@ void Controller::setProperty(const QString &name, const QVariant &value) {
  * @brief 获取MPV属性值函数
  */
 QVariant Controller::getProperty(const QString &name) const {
+    const QByteArray traceDetail = Trace::isEnabled() ? name.toUtf8() : QByteArray();
+    TRACE_SCOPE("mpv_get_property", "mpv", traceDetail.constData());
+
     auto result = mpv::qt::get_property_variant(mpv, name);
     if (mpv::qt::is_error(result)) {
-        QMessageBox::critical(reinterpret_cast<QWidget *>(application), tr("错误"),
-                              "MPV获取参数错误：" + QString::number(mpv::qt::get_error(result)));
+        reportError("MPV获取参数错误：", mpv::qt::get_error(result));
         return {};
     }
     return result;
 }
 
+/*!
+ * @brief 报告MPV错误，交给诊断通道限频后在状态栏提示，不阻塞事件循环
+ */
+void Controller::reportError(const QString &message, int error) const {
+    const QString text = message + QString::number(error) + " (" + mpv_error_string(error) + ")";
+    if (isHeadless()) {
+        qWarning().noquote() << text;
+    }
+    diagnostics->report(text, error);
+}
+
+/*!
+ * @brief 设置MPV发送日志的最低级别，取值为fatal、error、warn、info、v、debug、trace或no
+ */
+void Controller::setLogLevel(const QString &level) {
+    TRACE_FUNCTION("controller");
+
+    logLevel = level;
+    if (mpv) {
+        mpv_request_log_messages(mpv, level.toUtf8().constData());
+    }
+}
+
+/*!
+ * @brief 当前的日志级别
+ */
+const QString &Controller::getLogLevel() const {
+    return logLevel;
+}
+
+/*!
+ * @brief 返回MPV日志缓冲区
+ */
+const MpvLog &Controller::getMpvLog() const {
+    return mpvLog;
+}
+
+/*!
+ * @brief 返回诊断通道
+ */
+Diagnostics *Controller::getDiagnostics() const {
+    return diagnostics;
+}
+
+/*!
+ * @brief 返回监听得到的轨道列表
+ */
+const QVariantList &Controller::getTrackList() const {
+    return trackList;
+}
+
 /*!
  * @brief 返回mpv实例
  */
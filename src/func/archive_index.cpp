@@ -0,0 +1,401 @@
+#include "archive_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+/*!
+ * @brief 读取小端整数
+ */
+static inline quint16 le16(const uchar *data) {
+    return qFromLittleEndian<quint16>(data);
+}
+
+static inline quint32 le32(const uchar *data) {
+    return qFromLittleEndian<quint32>(data);
+}
+
+static inline quint64 le64(const uchar *data) {
+    return qFromLittleEndian<quint64>(data);
+}
+
+/*!
+ * @brief 解析TAR头中的数字字段：八进制文本，超过8GB的成员使用GNU的base-256二进制编码
+ */
+static int64_t parseTarNumber(const char *field, int length) {
+    const auto *bytes = reinterpret_cast<const uchar *>(field);
+    int64_t value = 0;
+    if (bytes[0] & 0x80) {
+        value = bytes[0] & 0x7F;
+        for (int i = 1; i < length; ++i) {
+            value = (value << 8) | bytes[i];
+        }
+        return value;
+    }
+
+    int i = 0;
+    while (i < length && (field[i] == ' ' || field[i] == '\0')) {
+        ++i;
+    }
+    for (; i < length && field[i] >= '0' && field[i] <= '7'; ++i) {
+        value = value * 8 + (field[i] - '0');
+    }
+    return value;
+}
+
+/*!
+ * @brief 读取以'\0'结尾、最长length字节的字符串字段
+ */
+static QString tarString(const char *field, int length) {
+    const void *end = std::memchr(field, '\0', static_cast<size_t>(length));
+    const int size = end ? static_cast<int>(static_cast<const char *>(end) - field) : length;
+    return QString::fromUtf8(field, size);
+}
+
+/*!
+ * @brief 校验TAR头的校验和，用于识别文件是否为TAR
+ */
+static bool tarChecksumValid(const QByteArray &header) {
+    const int64_t expected = parseTarNumber(header.constData() + 148, 8);
+    int64_t sum = 0;
+    for (int i = 0; i < 512; ++i) {
+        sum += (i >= 148 && i < 156) ? ' ' : static_cast<uchar>(header[i]);
+    }
+    return sum == expected;
+}
+
+/*!
+ * @brief 加载归档索引，同一文件在大小与修改时间不变时直接返回缓存的索引
+ */
+QSharedPointer<const ArchiveIndex> ArchiveIndex::load(const QString &path) {
+    static QMutex cacheMutex;
+    static QHash<QString, QSharedPointer<const ArchiveIndex>> cache;
+
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        return {};
+    }
+    const QString key = info.absoluteFilePath();
+
+    /*!
+     * @brief 索引可能同时被界面线程与MPV的解复用线程请求，加锁避免重复解析
+     */
+    QMutexLocker locker(&cacheMutex);
+    QSharedPointer<const ArchiveIndex> cached = cache.value(key);
+    if (cached && cached->archiveSize == info.size() && cached->lastModified == info.lastModified()) {
+        return cached;
+    }
+
+    QFile file(key);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    auto index = QSharedPointer<ArchiveIndex>::create();
+    index->archiveSize = info.size();
+    index->lastModified = info.lastModified();
+
+    const bool isZip = info.suffix().compare("zip", Qt::CaseInsensitive) == 0;
+    if (!(isZip ? index->parseZip(file) : index->parseTar(file))) {
+        return {};
+    }
+
+    for (int i = 0; i < index->entries.size(); ++i) {
+        index->entryIndex.insert(index->entries[i].name, i);
+    }
+
+    cache.insert(key, index);
+    return index;
+}
+
+/*!
+ * @brief 根据扩展名判断是否为支持的归档文件
+ */
+bool ArchiveIndex::isArchive(const QString &path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "zip" || suffix == "tar";
+}
+
+/*!
+ * @brief 生成archive://归档路径!/成员 形式的地址
+ */
+QString ArchiveIndex::toUri(const QString &archivePath, const QString &member) {
+    return QString(protocol) + "://" + archivePath + "!/" + member;
+}
+
+/*!
+ * @brief 拆分archive://地址，取第一个前缀为现有文件的"!/"作为分隔
+ */
+bool ArchiveIndex::parseUri(const QString &uri, QString *archivePath, QString *member) {
+    const QString prefix = QString(protocol) + "://";
+    if (!uri.startsWith(prefix)) {
+        return false;
+    }
+
+    const QString rest = uri.mid(prefix.size());
+    for (int separator = rest.indexOf("!/"); separator >= 0; separator = rest.indexOf("!/", separator + 1)) {
+        const QString path = rest.left(separator);
+        if (QFileInfo(path).isFile()) {
+            *archivePath = path;
+            *member = rest.mid(separator + 2);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ * @brief 查找成员
+ */
+const ArchiveEntry *ArchiveIndex::find(const QString &member) const {
+    auto it = entryIndex.constFind(member);
+    return it == entryIndex.constEnd() ? nullptr : &entries[it.value()];
+}
+
+/*!
+ * @brief 返回可以直接播放（未压缩）的成员列表
+ */
+QStringList ArchiveIndex::playableMembers() const {
+    QStringList members;
+    for (const ArchiveEntry &entry: entries) {
+        if (entry.stored) {
+            members.append(entry.name);
+        }
+    }
+    return members;
+}
+
+/*!
+ * @brief GNU长文件名与pax扩展头的大小上限，超过时视为损坏的归档，避免按头中的大小读入过多数据
+ */
+static constexpr int64_t maxTarExtensionSize = 1 << 20;
+
+/*!
+ * @brief 顺序读取TAR头建立索引，支持ustar前缀、GNU长文件名与pax扩展头
+ */
+bool ArchiveIndex::parseTar(QFile &file) {
+    int64_t offset = 0;
+    QString longName;
+    int64_t extendedSize = -1;
+
+    while (offset + 512 <= archiveSize) {
+        if (!file.seek(offset)) {
+            break;
+        }
+        const QByteArray header = file.read(512);
+        if (header.size() < 512) {
+            break;
+        }
+
+        /*!
+         * @brief 全零块表示归档结束
+         */
+        if (std::all_of(header.constBegin(), header.constEnd(), [](char c) { return c == '\0'; })) {
+            break;
+        }
+        if (!tarChecksumValid(header)) {
+            return false;
+        }
+
+        const char *data = header.constData();
+        const int64_t size = parseTarNumber(data + 124, 12);
+        const char type = data[156];
+        const int64_t dataOffset = offset + 512;
+        int64_t memberSize = size;
+
+        if ((type == 'L' || type == 'x') && (size < 0 || size > maxTarExtensionSize)) {
+            return false;
+        }
+
+        if (type == 'L') {
+            /*!
+             * @brief GNU长文件名，作用于下一个成员，归档被截断时按实际读到的长度处理
+             */
+            const QByteArray name = file.read(size);
+            longName = tarString(name.constData(), static_cast<int>(name.size()));
+        } else if (type == 'x') {
+            /*!
+             * @brief pax扩展头，格式为"长度 键=值\n"，只关心path与size
+             */
+            const QByteArray records = file.read(size);
+            int position = 0;
+            while (position < records.size()) {
+                const int space = records.indexOf(' ', position);
+                if (space < 0) {
+                    break;
+                }
+                const int length = records.mid(position, space - position).toInt();
+                if (length <= 0) {
+                    break;
+                }
+                const QByteArray record = records.mid(space + 1, length - (space - position) - 2);
+                if (record.startsWith("path=")) {
+                    longName = QString::fromUtf8(record.mid(5));
+                } else if (record.startsWith("size=")) {
+                    extendedSize = record.mid(5).toLongLong();
+                }
+                position += length;
+            }
+        } else {
+            /*!
+             * @brief 超过8 GiB的成员由pax头给出实际大小，ustar的size字段可能为0或被截断
+             */
+            memberSize = extendedSize >= 0 ? extendedSize : size;
+            if (type == '0' || type == '\0' || type == '7') {
+                QString name = longName;
+                if (name.isEmpty()) {
+                    name = tarString(data, 100);
+                    if (std::memcmp(data + 257, "ustar", 5) == 0 && data[345] != '\0') {
+                        name = tarString(data + 345, 155) + "/" + name;
+                    }
+                }
+                entries.append({name, dataOffset, memberSize, true});
+            }
+
+            /*!
+             * @brief 长文件名与pax头只作用于紧随其后的成员
+             */
+            longName.clear();
+            extendedSize = -1;
+        }
+
+        offset = dataOffset + (memberSize + 511) / 512 * 512;
+    }
+
+    return !entries.isEmpty();
+}
+
+/*!
+ * @brief 读取ZIP中央目录建立索引，支持ZIP64
+ */
+bool ArchiveIndex::parseZip(QFile &file) {
+    /*!
+     * @brief 在文件末尾查找中央目录结束记录
+     */
+    const int64_t tailSize = std::min<int64_t>(archiveSize, 65535 + 22);
+    file.seek(archiveSize - tailSize);
+    const QByteArray tail = file.read(tailSize);
+    const auto *tailData = reinterpret_cast<const uchar *>(tail.constData());
+
+    int endRecord = -1;
+    for (int i = tail.size() - 22; i >= 0; --i) {
+        if (le32(tailData + i) == 0x06054b50) {
+            endRecord = i;
+            break;
+        }
+    }
+    if (endRecord < 0) {
+        return false;
+    }
+
+    const uchar *end = tailData + endRecord;
+    int64_t count = le16(end + 10);
+    int64_t directorySize = le32(end + 12);
+    int64_t directoryOffset = le32(end + 16);
+
+    /*!
+     * @brief 超出32位范围的归档使用ZIP64结束记录
+     */
+    if (count == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF) {
+        if (endRecord < 20 || le32(end - 20) != 0x07064b50) {
+            return false;
+        }
+        file.seek(static_cast<qint64>(le64(end - 20 + 8)));
+        const QByteArray record = file.read(56);
+        const auto *recordData = reinterpret_cast<const uchar *>(record.constData());
+        if (record.size() < 56 || le32(recordData) != 0x06064b50) {
+            return false;
+        }
+        count = static_cast<int64_t>(le64(recordData + 32));
+        directorySize = static_cast<int64_t>(le64(recordData + 40));
+        directoryOffset = static_cast<int64_t>(le64(recordData + 48));
+    }
+
+    if (directoryOffset < 0 || directorySize <= 0 || directoryOffset + directorySize > archiveSize) {
+        return false;
+    }
+    file.seek(directoryOffset);
+    const QByteArray directory = file.read(directorySize);
+    if (directory.size() != directorySize) {
+        return false;
+    }
+    const auto *directoryData = reinterpret_cast<const uchar *>(directory.constData());
+
+    int position = 0;
+    for (int64_t i = 0; i < count && position + 46 <= directory.size(); ++i) {
+        const uchar *header = directoryData + position;
+        if (le32(header) != 0x02014b50) {
+            return false;
+        }
+
+        const quint16 flags = le16(header + 8);
+        const quint16 method = le16(header + 10);
+        int64_t compressedSize = le32(header + 20);
+        int64_t size = le32(header + 24);
+        const int nameLength = le16(header + 28);
+        const int extraLength = le16(header + 30);
+        const int commentLength = le16(header + 32);
+        int64_t localOffset = le32(header + 42);
+        if (position + 46 + nameLength + extraLength + commentLength > directory.size()) {
+            return false;
+        }
+
+        /*!
+         * @brief 标志位11表示文件名为UTF-8编码
+         */
+        const char *nameData = reinterpret_cast<const char *>(header + 46);
+        const QString name = (flags & 0x800) ? QString::fromUtf8(nameData, nameLength)
+                                             : QString::fromLocal8Bit(nameData, nameLength);
+
+        /*!
+         * @brief ZIP64扩展字段按顺序存放被置为0xFFFFFFFF的字段；子字段长度超出扩展区时停止解析，避免越界读取
+         */
+        const uchar *extra = header + 46 + nameLength;
+        for (int e = 0; e + 4 <= extraLength;) {
+            const quint16 id = le16(extra + e);
+            const int length = le16(extra + e + 2);
+            if (e + 4 + length > extraLength) {
+                break;
+            }
+            if (id == 0x0001) {
+                const uchar *field = extra + e + 4;
+                int used = 0;
+                if (size == 0xFFFFFFFF && used + 8 <= length) {
+                    size = static_cast<int64_t>(le64(field + used));
+                    used += 8;
+                }
+                if (compressedSize == 0xFFFFFFFF && used + 8 <= length) {
+                    compressedSize = static_cast<int64_t>(le64(field + used));
+                    used += 8;
+                }
+                if (localOffset == 0xFFFFFFFF && used + 8 <= length) {
+                    localOffset = static_cast<int64_t>(le64(field + used));
+                }
+            }
+            e += 4 + length;
+        }
+        position += 46 + nameLength + extraLength + commentLength;
+
+        if (name.endsWith('/')) {
+            continue;
+        }
+
+        /*!
+         * @brief 只有未加密的stored成员可以直接读取，数据起点需从本地文件头计算
+         */
+        bool stored = method == 0 && !(flags & 0x1);
+        int64_t dataOffset = -1;
+        if (stored) {
+            file.seek(localOffset);
+            const QByteArray local = file.read(30);
+            const auto *localData = reinterpret_cast<const uchar *>(local.constData());
+            if (local.size() == 30 && le32(localData) == 0x04034b50) {
+                dataOffset = localOffset + 30 + le16(localData + 26) + le16(localData + 28);
+            } else {
+                stored = false;
+            }
+        }
+        entries.append({name, dataOffset, stored ? size : compressedSize, stored});
+    }
+
+    return !entries.isEmpty();
+}
@@ -0,0 +1,84 @@
+#include "contact_sheet.h"
+
+#include <QImageWriter>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QTime>
+
+/*!
+ * @brief 格子之间及四周的间距
+ */
+static constexpr int spacing = 4;
+
+ContactSheet::ContactSheet(int count, int columns, const QSize &tileSize)
+        : columns(qMax(1, columns)), tileSize(tileSize) {
+    const int rows = (qMax(1, count) + this->columns - 1) / this->columns;
+    canvas = QImage(spacing + this->columns * (tileSize.width() + spacing),
+                    spacing + rows * (tileSize.height() + spacing), QImage::Format_RGB32);
+    canvas.fill(QColor(24, 24, 24));
+}
+
+/*!
+ * @brief 缩放帧并绘制到第index格，右下角标注time的时间码，time应为帧的实际位置而非请求的时间点
+ */
+void ContactSheet::addFrame(int index, double time, const QImage &frame) {
+    const QImage scaled = frame.scaled(tileSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    const QRect rect = tileRect(index);
+    const QString timecode = QTime(0, 0).addMSecs(static_cast<int>(time * 1000)).toString("hh:mm:ss");
+
+    QMutexLocker locker(&mutex);
+    QPainter painter(&canvas);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    /*!
+     * @brief 宽高比与格子不一致时居中放置
+     */
+    painter.drawImage(rect.x() + (rect.width() - scaled.width()) / 2,
+                      rect.y() + (rect.height() - scaled.height()) / 2, scaled);
+
+    QFont font = painter.font();
+    font.setPixelSize(qMax(10, tileSize.height() / 10));
+    painter.setFont(font);
+    const QRect textRect = painter.fontMetrics().boundingRect(timecode).adjusted(-4, -2, 4, 2);
+    const QRect label(rect.right() - textRect.width() - 2, rect.bottom() - textRect.height() - 2,
+                      textRect.width(), textRect.height());
+    painter.fillRect(label, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    painter.drawText(label, Qt::AlignCenter, timecode);
+}
+
+/*!
+ * @brief 按指定格式与质量写出，format为"jpg"或"webp"
+ */
+bool ContactSheet::save(const QString &fileName, const QByteArray &format, int quality) const {
+    QMutexLocker locker(&mutex);
+    QImageWriter writer(fileName, format);
+    writer.setQuality(quality);
+    writer.setOptimizedWrite(true);
+    return writer.write(canvas);
+}
+
+/*!
+ * @brief 根据视频的显示尺寸计算格子大小，尺寸未知时按16:9处理
+ */
+QSize ContactSheet::tileSizeFor(int tileWidth, int videoWidth, int videoHeight) {
+    if (videoWidth <= 0 || videoHeight <= 0) {
+        return {tileWidth, tileWidth * 9 / 16};
+    }
+    return {tileWidth, qMax(1, tileWidth * videoHeight / videoWidth)};
+}
+
+/*!
+ * @brief WebP需要Qt的图像格式插件，未安装时不提供该选项
+ */
+bool ContactSheet::isFormatSupported(const QByteArray &format) {
+    return QImageWriter::supportedImageFormats().contains(format);
+}
+
+/*!
+ * @brief 第index格在画布上的位置
+ */
+QRect ContactSheet::tileRect(int index) const {
+    return {spacing + index % columns * (tileSize.width() + spacing),
+            spacing + index / columns * (tileSize.height() + spacing), tileSize.width(), tileSize.height()};
+}
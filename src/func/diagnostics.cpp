@@ -0,0 +1,93 @@
+#include "diagnostics.h"
+
+#include <QSaveFile>
+#include <QTextStream>
+#include <QCoreApplication>
+
+#include <cstring>
+
+Diagnostics::Diagnostics(QObject *parent) : QObject(parent), drainScheduled(false), dropped(0) {
+    clock.start();
+}
+
+/*!
+ * @brief 报告错误，可在任意线程中调用，队列已满时只计数
+ */
+void Diagnostics::report(const QString &message, int code) {
+    PendingError error;
+    error.timestamp = QDateTime::currentMSecsSinceEpoch();
+    error.code = code;
+    const QByteArray text = message.toUtf8();
+    std::strncpy(error.message, text.constData(), sizeof(error.message) - 1);
+
+    if (!pending.push(error)) {
+        ++dropped;
+    }
+
+    /*!
+     * @brief 同一时间只投递一次处理，处理开始前到来的错误由同一次处理取出
+     */
+    if (!drainScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, &Diagnostics::drain, Qt::QueuedConnection);
+    }
+}
+
+/*!
+ * @brief 在主线程中取出队列中的错误，记录并按错误码限频提示
+ */
+void Diagnostics::drain() {
+    drainScheduled = false;
+
+    PendingError error;
+    while (pending.pop(error)) {
+        const qint64 now = clock.elapsed();
+        const auto shown = lastShown.constFind(error.code);
+        if (shown != lastShown.constEnd() && now - *shown < rateLimitWindow) {
+            /*!
+             * @brief 限频窗口内的重复错误合并到该错误码最近的一条记录
+             */
+            for (auto it = records.rbegin(); it != records.rend(); ++it) {
+                if (it->code == error.code) {
+                    ++it->repeats;
+                    break;
+                }
+            }
+            continue;
+        }
+
+        lastShown.insert(error.code, now);
+        records.append({QDateTime::fromMSecsSinceEpoch(error.timestamp), error.code,
+                        QString::fromUtf8(error.message), 0});
+        if (records.size() > maximumRecords) {
+            records.removeFirst();
+        }
+        emit errorShown(records.last().message);
+    }
+}
+
+/*!
+ * @brief 导出诊断日志
+ */
+bool Diagnostics::exportLog(const QString &fileName) {
+    drain();
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    stream << QCoreApplication::applicationName() << " " << QCoreApplication::applicationVersion() << "\n";
+    stream << "exported: " << QDateTime::currentDateTime().toString(Qt::ISODateWithMs) << "\n";
+    stream << "dropped: " << dropped.load() << "\n\n";
+    for (const Record &record: records) {
+        stream << record.time.toString(Qt::ISODateWithMs) << " [" << record.code << "] " << record.message;
+        if (record.repeats > 0) {
+            stream << " (+" << record.repeats << ")";
+        }
+        stream << "\n";
+    }
+    stream.flush();
+    return stream.status() == QTextStream::Ok && file.commit();
+}
@@ -0,0 +1,99 @@
+#include "encode_pipeline.h"
+
+#include <QMutexLocker>
+
+/*!
+ * @brief 每个编码线程对应的待编码帧数
+ */
+static constexpr int framesPerEncoder = 2;
+
+EncodePipeline::EncodePipeline()
+        : encodeSlots(framesPerEncoder * QThread::idealThreadCount()), cancelled(false), outstanding(0) {}
+
+EncodePipeline::~EncodePipeline() {
+    /*!
+     * @brief 取消并等待所有任务结束，任务中引用了所有者
+     */
+    cancel();
+    for (QThread *worker: workers) {
+        worker->wait();
+        delete worker;
+    }
+    encodePool.waitForDone();
+}
+
+/*!
+ * @brief 启动取帧线程，每个对象只能使用一次
+ */
+void EncodePipeline::start(int workerCount, const Worker &worker, const Finished &onFinished,
+                           QThread::Priority priority) {
+    finished = onFinished;
+    outstanding = workerCount;
+    for (int i = 0; i < workerCount; ++i) {
+        QThread *thread = QThread::create([this, worker, i]() {
+            worker(i);
+            release();
+        });
+        workers.append(thread);
+        thread->start(priority);
+    }
+}
+
+/*!
+ * @brief 在取帧线程中提交一个编码任务，待编码的任务达到上限时等待线程池处理完成
+ */
+void EncodePipeline::submit(const std::function<void()> &task) {
+    encodeSlots.acquire();
+    ++outstanding;
+    encodePool.start([this, task]() {
+        task();
+        encodeSlots.release();
+        release();
+    });
+}
+
+/*!
+ * @brief 登记取帧线程正在使用的FrameGrabber，取消时将其中断；已取消时立即中断
+ */
+void EncodePipeline::attach(FrameGrabber *grabber) {
+    QMutexLocker locker(&grabberMutex);
+    if (cancelled) {
+        grabber->abort();
+    }
+    activeGrabbers.append(grabber);
+}
+
+/*!
+ * @brief 取消登记，须在FrameGrabber销毁之前调用
+ */
+void EncodePipeline::detach(FrameGrabber *grabber) {
+    QMutexLocker locker(&grabberMutex);
+    activeGrabbers.removeOne(grabber);
+}
+
+/*!
+ * @brief 取消，已经在途的取帧立即中断，尚未执行的编码任务应检查isCancelled()后跳过
+ */
+void EncodePipeline::cancel() {
+    cancelled = true;
+    QMutexLocker locker(&grabberMutex);
+    for (FrameGrabber *grabber: activeGrabbers) {
+        grabber->abort();
+    }
+}
+
+/*!
+ * @brief 是否已取消
+ */
+bool EncodePipeline::isCancelled() const {
+    return cancelled;
+}
+
+/*!
+ * @brief 取帧线程或编码任务结束，全部结束时调用finished
+ */
+void EncodePipeline::release() {
+    if (--outstanding == 0 && finished) {
+        finished();
+    }
+}
@@ -0,0 +1,151 @@
+#include "frame_capture.h"
+#include "frame_grabber.h"
+
+#include <QClipboard>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImageWriter>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTime>
+
+FrameCapture::FrameCapture(mpv_handle *mpv, QObject *parent) : QObject(parent), mpv(mpv), counter(0) {
+    /*!
+     * @brief 两个线程足以让连续截图的编码重叠进行，又不与解码争抢CPU
+     */
+    pool.setMaxThreadCount(2);
+}
+
+FrameCapture::~FrameCapture() {
+    pool.waitForDone();
+}
+
+/*!
+ * @brief 读取截图选项
+ */
+FrameCapture::Options FrameCapture::loadOptions() {
+    QSettings settings("settings.ini", QSettings::IniFormat);
+    settings.beginGroup("capture");
+    Options options;
+    options.directory = settings.value(
+            "directory", QStandardPaths::writableLocation(QStandardPaths::PicturesLocation) + "/AstraPlay").toString();
+    options.fileTemplate = settings.value("template", "%title%_%time%_%date%").toString();
+    options.format = settings.value("format", "png").toByteArray();
+    options.quality = settings.value("quality", 90).toInt();
+    options.copyToClipboard = settings.value("clipboard", false).toBool();
+    settings.endGroup();
+    return options;
+}
+
+/*!
+ * @brief 保存截图选项
+ */
+void FrameCapture::saveOptions(const Options &options) {
+    QSettings settings("settings.ini", QSettings::IniFormat);
+    settings.beginGroup("capture");
+    settings.setValue("directory", options.directory);
+    settings.setValue("template", options.fileTemplate);
+    settings.setValue("format", options.format);
+    settings.setValue("quality", options.quality);
+    settings.setValue("clipboard", options.copyToClipboard);
+    settings.endGroup();
+}
+
+/*!
+ * @brief 展开文件名模板：%title%为不含扩展名的文件名，%time%为播放位置，%date%为当前日期时间，%n%为本次运行中的截图序号
+ */
+QString FrameCapture::expandTemplate(const QString &fileTemplate, const QString &title, double timePos, int number) {
+    QString name = fileTemplate;
+    name.replace("%title%", title.isEmpty() ? QString("AstraPlay") : title);
+    name.replace("%time%", QTime(0, 0).addMSecs(static_cast<int>(timePos * 1000)).toString("hh-mm-ss-zzz"));
+    name.replace("%date%", QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+    name.replace("%n%", QString("%1").arg(number, 4, 10, QChar('0')));
+
+    /*!
+     * @brief 去掉文件名中不允许的字符
+     */
+    name.replace(QRegularExpression(R"([\\/:*?"<>|])"), "_");
+    return name.trimmed().isEmpty() ? QString("AstraPlay_%1").arg(number) : name;
+}
+
+/*!
+ * @brief 截取当前帧，立即返回，结果通过captured()或captureFailed()通知
+ */
+void FrameCapture::capture() {
+    const Options options = loadOptions();
+    const int number = ++counter;
+    pool.start([this, options, number]() { captureTask(options, number); });
+}
+
+/*!
+ * @brief 后台线程：截图、可选复制到剪贴板、编码并保存，MPV的客户端接口可在任意线程中调用
+ */
+void FrameCapture::captureTask(const Options &options, int number) {
+    double timePos = 0.0;
+    mpv_get_property(mpv, "time-pos", MPV_FORMAT_DOUBLE, &timePos);
+    char *title = mpv_get_property_string(mpv, "filename/no-ext");
+    const QString mediaTitle = title ? QString::fromUtf8(title) : QString();
+    mpv_free(title);
+
+    /*!
+     * @brief 结果节点由图像接管，像素数据不做拷贝
+     */
+    auto *result = new mpv_node;
+    const char *args[] = {"screenshot-raw", "video", nullptr};
+    const int error = mpv_command_ret(mpv, args, result);
+    if (error < 0) {
+        delete result;
+        emit captureFailed(tr("截图失败：%1").arg(mpv_error_string(error)));
+        return;
+    }
+    const QImage image = FrameGrabber::toImage(result);
+    if (image.isNull()) {
+        emit captureFailed(tr("截图失败：不支持的图像格式"));
+        return;
+    }
+
+    /*!
+     * @brief 剪贴板只能在界面线程中操作
+     */
+    if (options.copyToClipboard) {
+        QMetaObject::invokeMethod(qApp, [image]() {
+            QGuiApplication::clipboard()->setImage(image);
+        }, Qt::QueuedConnection);
+    }
+
+    if (!QDir().mkpath(options.directory)) {
+        emit captureFailed(tr("无法创建截图目录：%1").arg(options.directory));
+        return;
+    }
+
+    /*!
+     * @brief 以NewOnly方式创建文件，连续截图同名时依次加序号，不会互相覆盖
+     */
+    const QString baseName = options.directory + "/" + expandTemplate(options.fileTemplate, mediaTitle, timePos, number);
+    QFile file;
+    for (int suffix = 0; suffix < 1000; ++suffix) {
+        file.setFileName(baseName + (suffix ? QString("_%1").arg(suffix) : QString()) + "." + options.format);
+        if (file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+            break;
+        }
+    }
+    if (!file.isOpen()) {
+        emit captureFailed(tr("无法创建截图文件：%1").arg(baseName));
+        return;
+    }
+
+    QImageWriter writer(&file, options.format);
+    if (options.format != "png") {
+        writer.setQuality(options.quality);
+    }
+    if (!writer.write(image)) {
+        file.remove();
+        emit captureFailed(tr("无法保存截图：%1").arg(writer.errorString()));
+        return;
+    }
+    file.close();
+    emit captured(file.fileName());
+}
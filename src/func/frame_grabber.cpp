@@ -0,0 +1,271 @@
+#include "frame_grabber.h"
+
+#include <QByteArray>
+#include <QDebug>
+
+#include <cstring>
+
+FrameGrabber::FrameGrabber(int width, bool skipLoopFilter) : mpv(mpv_create()), duration(0.0), aborted(false) {
+    if (!mpv) {
+        qWarning() << "无法创建取帧用的MPV实例";
+        return;
+    }
+
+    /*!
+     * @brief 不输出视频与音频，不加载脚本与配置，避免占用主播放器的资源
+     */
+    mpv_set_option_string(mpv, "vo", "null");
+    mpv_set_option_string(mpv, "ao", "null");
+    mpv_set_option_string(mpv, "aid", "no");
+    mpv_set_option_string(mpv, "sid", "no");
+    mpv_set_option_string(mpv, "audio-display", "no");
+    mpv_set_option_string(mpv, "load-scripts", "no");
+    mpv_set_option_string(mpv, "ytdl", "no");
+    mpv_set_option_string(mpv, "terminal", "no");
+    mpv_set_option_string(mpv, "input-default-bindings", "no");
+
+    /*!
+     * @brief 暂停状态下跳转只解码目标帧，播放到结尾时保留最后一帧
+     */
+    mpv_set_option_string(mpv, "pause", "yes");
+    mpv_set_option_string(mpv, "keep-open", "always");
+
+    /*!
+     * @brief 软件解码并限制解码线程数
+     */
+    mpv_set_option_string(mpv, "hwdec", "no");
+    mpv_set_option_string(mpv, "vd-lavc-threads", "2");
+    mpv_set_option_string(mpv, "cache", "no");
+    if (skipLoopFilter) {
+        mpv_set_option_string(mpv, "vd-lavc-skiploopfilter", "all");
+    }
+
+    if (width > 0) {
+        mpv_set_option_string(mpv, "vf", QString("scale=w=%1:h=-2").arg(width).toUtf8().constData());
+    }
+
+    if (mpv_initialize(mpv) < 0) {
+        qWarning() << "取帧用的MPV实例初始化失败";
+        mpv_terminate_destroy(mpv);
+        mpv = nullptr;
+        return;
+    }
+
+    /*!
+     * @brief 与主播放器使用相同的读取方式打开大文件与归档成员
+     */
+    LocalStream::registerProtocol(mpv);
+
+    /*!
+     * @brief 逐帧前进时通过播放位置的变化判断新帧已解码
+     */
+    mpv_observe_property(mpv, TimePosProperty, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, EofReachedProperty, "eof-reached", MPV_FORMAT_FLAG);
+}
+
+FrameGrabber::~FrameGrabber() {
+    if (mpv) {
+        mpv_terminate_destroy(mpv);
+    }
+}
+
+/*!
+ * @brief 返回MPV实例
+ */
+mpv_handle *FrameGrabber::getMpvInstance() const {
+    return mpv;
+}
+
+/*!
+ * @brief 加载文件并等待第一帧解码完成，避免加载时的PLAYBACK_RESTART事件被之后的跳转误认
+ */
+bool FrameGrabber::open(const QString &path, int timeout) {
+    if (!mpv || aborted) {
+        return false;
+    }
+
+    const QString uri = LocalStream::isSuitable(path) ? LocalStream::toUri(path) : path;
+    const QByteArray uriData = uri.toUtf8();
+    const char *args[] = {"loadfile", uriData.constData(), nullptr};
+    if (mpv_command(mpv, args) < 0 || !waitForEvent(MPV_EVENT_FILE_LOADED, timeout) ||
+        !waitForEvent(MPV_EVENT_PLAYBACK_RESTART, timeout)) {
+        duration = 0.0;
+        return false;
+    }
+
+    if (mpv_get_property(mpv, "duration", MPV_FORMAT_DOUBLE, &duration) < 0) {
+        duration = 0.0;
+    }
+    return true;
+}
+
+/*!
+ * @brief 返回已加载文件的时长
+ */
+double FrameGrabber::getDuration() const {
+    return duration;
+}
+
+/*!
+ * @brief 跳转到指定时间并取帧，exact为false时只跳转到最近的关键帧，速度快得多
+ */
+QImage FrameGrabber::grab(double seconds, bool exact, int timeout) {
+    if (!mpv || aborted) {
+        return {};
+    }
+
+    const QByteArray position = QByteArray::number(seconds, 'f', 3);
+    const char *args[] = {"seek", position.constData(), exact ? "absolute+exact" : "absolute+keyframes", nullptr};
+    if (mpv_command(mpv, args) < 0 || !waitForEvent(MPV_EVENT_PLAYBACK_RESTART, timeout)) {
+        return {};
+    }
+    return grabCurrent();
+}
+
+/*!
+ * @brief 取当前显示的帧
+ */
+QImage FrameGrabber::grabCurrent() {
+    if (!mpv || aborted) {
+        return {};
+    }
+
+    auto *result = new mpv_node;
+    const char *args[] = {"screenshot-raw", "video", nullptr};
+    if (mpv_command_ret(mpv, args, result) < 0) {
+        delete result;
+        return {};
+    }
+    return toImage(result);
+}
+
+/*!
+ * @brief 前进一帧（frame-step）并等待该帧解码完成，到达文件末尾、超时或被中断时返回false
+ */
+bool FrameGrabber::step(int timeout) {
+    if (!mpv || aborted) {
+        return false;
+    }
+
+    const double before = getTimePos();
+    const char *args[] = {"frame-step", nullptr};
+    if (mpv_command(mpv, args) < 0) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!aborted) {
+        const qint64 remaining = timeout - timer.elapsed();
+        if (remaining <= 0) {
+            return false;
+        }
+
+        const mpv_event *event = mpv_wait_event(mpv, static_cast<double>(remaining) / 1000.0);
+        if (event->event_id != MPV_EVENT_PROPERTY_CHANGE) {
+            continue;
+        }
+        const auto *property = static_cast<const mpv_event_property *>(event->data);
+        if (event->reply_userdata == TimePosProperty && property->format == MPV_FORMAT_DOUBLE &&
+            *static_cast<double *>(property->data) != before) {
+            return true;
+        }
+        if (event->reply_userdata == EofReachedProperty && property->format == MPV_FORMAT_FLAG &&
+            *static_cast<int *>(property->data)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/*!
+ * @brief 返回当前帧的播放位置
+ */
+double FrameGrabber::getTimePos() const {
+    double timePos = 0.0;
+    if (mpv) {
+        mpv_get_property(mpv, "time-pos", MPV_FORMAT_DOUBLE, &timePos);
+    }
+    return timePos;
+}
+
+/*!
+ * @brief 中断正在等待的加载或跳转，之后所有操作都会失败，可在其他线程中调用
+ */
+void FrameGrabber::abort() {
+    aborted = true;
+    if (mpv) {
+        mpv_wakeup(mpv);
+    }
+}
+
+/*!
+ * @brief 将screenshot-raw返回的节点转换为QImage并接管节点，图像直接引用节点中的像素数据，释放图像时释放节点
+ */
+QImage FrameGrabber::toImage(mpv_node *node) {
+    int64_t width = 0, height = 0, stride = 0;
+    const char *format = nullptr;
+    const void *pixels = nullptr;
+
+    if (node->format == MPV_FORMAT_NODE_MAP) {
+        const mpv_node_list *list = node->u.list;
+        for (int i = 0; i < list->num; ++i) {
+            const char *key = list->keys[i];
+            const mpv_node &value = list->values[i];
+            if (std::strcmp(key, "w") == 0 && value.format == MPV_FORMAT_INT64) {
+                width = value.u.int64;
+            } else if (std::strcmp(key, "h") == 0 && value.format == MPV_FORMAT_INT64) {
+                height = value.u.int64;
+            } else if (std::strcmp(key, "stride") == 0 && value.format == MPV_FORMAT_INT64) {
+                stride = value.u.int64;
+            } else if (std::strcmp(key, "format") == 0 && value.format == MPV_FORMAT_STRING) {
+                format = value.u.string;
+            } else if (std::strcmp(key, "data") == 0 && value.format == MPV_FORMAT_BYTE_ARRAY) {
+                pixels = value.u.ba->data;
+            }
+        }
+    }
+
+    auto release = [](void *info) {
+        auto *data = static_cast<mpv_node *>(info);
+        mpv_free_node_contents(data);
+        delete data;
+    };
+
+    /*!
+     * @brief bgr0在小端机器上的内存布局与Format_RGB32一致
+     */
+    if (!pixels || !format || std::strcmp(format, "bgr0") != 0 || width <= 0 || height <= 0) {
+        release(node);
+        return {};
+    }
+    return {static_cast<const uchar *>(pixels), static_cast<int>(width), static_cast<int>(height),
+            static_cast<int>(stride), QImage::Format_RGB32, release, node};
+}
+
+/*!
+ * @brief 等待指定事件，加载失败、超时或被中断时返回false
+ */
+bool FrameGrabber::waitForEvent(mpv_event_id id, int timeout) {
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!aborted) {
+        const qint64 remaining = timeout - timer.elapsed();
+        if (remaining <= 0) {
+            return false;
+        }
+
+        const mpv_event *event = mpv_wait_event(mpv, static_cast<double>(remaining) / 1000.0);
+        if (event->event_id == id) {
+            return true;
+        }
+        if (event->event_id == MPV_EVENT_END_FILE) {
+            const auto *endFile = static_cast<const mpv_event_end_file *>(event->data);
+            if (endFile->reason == MPV_END_FILE_REASON_ERROR) {
+                return false;
+            }
+        }
+    }
+    return false;
+}
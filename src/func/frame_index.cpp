@@ -0,0 +1,201 @@
+#include "frame_index.h"
+#include "local_stream.h"
+#include "thumbnail_sheet.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+#include "mpv/client.h"
+
+/*!
+ * @brief 索引文件头，格式变化时递增版本号，旧索引会被视为不存在
+ */
+static constexpr quint32 indexMagic = 0x41534649;  // "ASFI"
+static constexpr quint16 indexVersion = 1;
+
+/*!
+ * @brief 比较时间戳时允许的误差，MPV报告的播放位置与showinfo的时间戳可能有微小的舍入差异
+ */
+static constexpr double timeTolerance = 1e-4;
+
+/*!
+ * @brief 读取已缓存的索引，不存在或文件已变化时返回空指针
+ */
+QSharedPointer<const FrameIndex> FrameIndex::load(const QString &path) {
+    const QString indexPath = cachePath(path);
+    if (indexPath.isEmpty()) {
+        return {};
+    }
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic = 0;
+    quint16 version = 0;
+    auto index = QSharedPointer<FrameIndex>::create();
+    stream >> magic >> version >> index->times >> index->keyframes;
+    if (stream.status() != QDataStream::Ok || magic != indexMagic || version != indexVersion ||
+        index->times.size() != index->keyframes.size() || index->times.isEmpty()) {
+        return {};
+    }
+    return index;
+}
+
+/*!
+ * @brief 解码整个文件建立索引，耗时与文件长度成正比，应在后台线程中调用，aborted置位时尽快返回空指针
+ */
+QSharedPointer<const FrameIndex> FrameIndex::build(const QString &path, const std::atomic<bool> &aborted) {
+    mpv_handle *mpv = mpv_create();
+    if (!mpv) {
+        return {};
+    }
+
+    /*!
+     * @brief 不输出视频与音频，不按时间播放；跳过IDCT与环路滤波后画面内容无效，但帧的时间戳与类型不受影响
+     */
+    mpv_set_option_string(mpv, "vo", "null");
+    mpv_set_option_string(mpv, "ao", "null");
+    mpv_set_option_string(mpv, "aid", "no");
+    mpv_set_option_string(mpv, "sid", "no");
+    mpv_set_option_string(mpv, "audio-display", "no");
+    mpv_set_option_string(mpv, "load-scripts", "no");
+    mpv_set_option_string(mpv, "ytdl", "no");
+    mpv_set_option_string(mpv, "terminal", "no");
+    mpv_set_option_string(mpv, "untimed", "yes");
+    mpv_set_option_string(mpv, "framedrop", "no");
+    mpv_set_option_string(mpv, "hwdec", "no");
+    mpv_set_option_string(mpv, "vd-lavc-skipidct", "all");
+    mpv_set_option_string(mpv, "vd-lavc-skiploopfilter", "all");
+    mpv_set_option_string(mpv, "vd-lavc-fast", "yes");
+    mpv_set_option_string(mpv, "vf", "lavfi=[showinfo]");
+
+    if (mpv_initialize(mpv) < 0) {
+        mpv_terminate_destroy(mpv);
+        return {};
+    }
+    LocalStream::registerProtocol(mpv);
+
+    /*!
+     * @brief FFmpeg的info级日志在MPV中对应v级
+     */
+    mpv_request_log_messages(mpv, "v");
+
+    const QByteArray uri = (LocalStream::isSuitable(path) ? LocalStream::toUri(path) : path).toUtf8();
+    const char *args[] = {"loadfile", uri.constData(), nullptr};
+    if (mpv_command(mpv, args) < 0) {
+        mpv_terminate_destroy(mpv);
+        return {};
+    }
+
+    static const QRegularExpression pattern(R"(pts_time:\s*(-?[0-9.]+(?:[eE][-+]?\d+)?).*iskey:\s*(\d))");
+    QVector<QPair<double, bool>> frames;
+    bool completed = false;
+    while (!aborted) {
+        const mpv_event *event = mpv_wait_event(mpv, 0.25);
+        if (event->event_id == MPV_EVENT_LOG_MESSAGE) {
+            const auto *message = static_cast<const mpv_event_log_message *>(event->data);
+            if (std::strstr(message->text, "pts_time:")) {
+                const QRegularExpressionMatch match = pattern.match(QString::fromUtf8(message->text));
+                if (match.hasMatch()) {
+                    frames.append({match.captured(1).toDouble(), match.captured(2) == "1"});
+                }
+            }
+        } else if (event->event_id == MPV_EVENT_END_FILE) {
+            completed = static_cast<const mpv_event_end_file *>(event->data)->reason == MPV_END_FILE_REASON_EOF;
+            break;
+        } else if (event->event_id == MPV_EVENT_SHUTDOWN) {
+            break;
+        }
+    }
+    mpv_terminate_destroy(mpv);
+
+    if (!completed || frames.isEmpty()) {
+        return {};
+    }
+
+    /*!
+     * @brief 滤镜按显示顺序输出，排序只为防止个别时间戳乱序
+     */
+    std::stable_sort(frames.begin(), frames.end(), [](const QPair<double, bool> &a, const QPair<double, bool> &b) {
+        return a.first < b.first;
+    });
+    auto index = QSharedPointer<FrameIndex>::create();
+    index->times.reserve(frames.size());
+    index->keyframes.reserve(frames.size());
+    for (const auto &frame: frames) {
+        index->times.append(frame.first);
+        index->keyframes.append(frame.second);
+    }
+    index->save(path);
+    return index;
+}
+
+/*!
+ * @brief 帧数
+ */
+int FrameIndex::frameCount() const {
+    return static_cast<int>(times.size());
+}
+
+/*!
+ * @brief 返回time处显示的帧号（从0开始），time早于第一帧时返回-1
+ */
+int FrameIndex::frameAt(double time) const {
+    const auto it = std::upper_bound(times.constBegin(), times.constEnd(), time + timeTolerance);
+    return static_cast<int>(it - times.constBegin()) - 1;
+}
+
+/*!
+ * @brief 帧的显示时间
+ */
+double FrameIndex::timeOf(int frame) const {
+    return times.value(frame, 0.0);
+}
+
+/*!
+ * @brief 是否为关键帧
+ */
+bool FrameIndex::isKeyframe(int frame) const {
+    return keyframes.value(frame, false);
+}
+
+/*!
+ * @brief 索引缓存路径，与缩略图拼图使用相同的文件标识
+ */
+QString FrameIndex::cachePath(const QString &path) {
+    const QString key = ThumbnailSheet::cacheKey(path);
+    if (key.isEmpty()) {
+        return {};
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/frames/" + key + ".idx";
+}
+
+/*!
+ * @brief 保存索引
+ */
+bool FrameIndex::save(const QString &path) const {
+    const QString indexPath = cachePath(path);
+    if (indexPath.isEmpty() || !QDir().mkpath(QFileInfo(indexPath).absolutePath())) {
+        return false;
+    }
+
+    QSaveFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << indexMagic << indexVersion << times << keyframes;
+    return stream.status() == QDataStream::Ok && file.commit();
+}
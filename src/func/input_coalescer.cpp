@@ -0,0 +1,86 @@
+#include "input_coalescer.h"
+
+/*!
+ * @brief 注册通道
+ */
+void InputCoalescer::addChannel(const QString &key, const Sender &sender) {
+    channels[key].sender = sender;
+}
+
+/*!
+ * @brief 加入调整量，通道空闲时立即发出，否则与尚未发出的调整量合并
+ */
+void InputCoalescer::add(const QString &key, double amount) {
+    auto it = channels.find(key);
+    if (it == channels.end()) {
+        return;
+    }
+
+    it->queuedAmount += amount;
+    it->hasQueued = true;
+    if (!it->inFlight) {
+        send(*it);
+    }
+}
+
+/*!
+ * @brief 通道上的请求已完成，有积压的调整量时发出
+ */
+void InputCoalescer::complete(const QString &key) {
+    auto it = channels.find(key);
+    if (it == channels.end() || !it->inFlight) {
+        return;
+    }
+
+    it->inFlight = false;
+    it->inFlightAmount = 0.0;
+    if (it->hasQueued) {
+        send(*it);
+    }
+}
+
+/*!
+ * @brief 丢弃尚未发出的调整量，用于被绝对设置（如重置）取代的情况
+ */
+void InputCoalescer::discard(const QString &key) {
+    auto it = channels.find(key);
+    if (it != channels.end()) {
+        it->queuedAmount = 0.0;
+        it->hasQueued = false;
+    }
+}
+
+/*!
+ * @brief 丢弃所有通道的积压并视为空闲，用于切换文件等场合
+ */
+void InputCoalescer::reset() {
+    for (Channel &channel: channels) {
+        channel.inFlight = false;
+        channel.inFlightAmount = 0.0;
+        channel.queuedAmount = 0.0;
+        channel.hasQueued = false;
+    }
+}
+
+/*!
+ * @brief 已发出但未完成与尚未发出的调整量之和，用于越界判断
+ */
+double InputCoalescer::pending(const QString &key) const {
+    auto it = channels.constFind(key);
+    if (it == channels.constEnd()) {
+        return 0.0;
+    }
+    return it->inFlightAmount + it->queuedAmount;
+}
+
+/*!
+ * @brief 发出通道上累计的调整量
+ */
+void InputCoalescer::send(Channel &channel) {
+    const double amount = channel.queuedAmount;
+    channel.queuedAmount = 0.0;
+    channel.hasQueued = false;
+    channel.inFlight = true;
+    channel.inFlightAmount = amount;
+    channel.sender(amount);
+}
@@ -0,0 +1,288 @@
+#include "io_uring_queue.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtGlobal>
+
+#if defined(Q_OS_LINUX) && __has_include(<linux/io_uring.h>)
+#define ASTRAPLAY_IO_URING
+#endif
+
+#ifdef ASTRAPLAY_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+/*!
+ * @brief 提交队列的长度，同时也是在途读取数的上限，超出时由调用方改用线程池
+ */
+static constexpr unsigned queueDepth = 64;
+
+/*!
+ * @brief 映射到进程中的提交队列与完成队列
+ */
+struct IoUringQueue::Ring {
+    int fd = -1;
+
+    void *sqRing = MAP_FAILED;
+
+    size_t sqRingSize = 0;
+
+    void *cqRing = MAP_FAILED;
+
+    size_t cqRingSize = 0;
+
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+
+    size_t sqesSize = 0;
+
+    unsigned *sqTail = nullptr;
+
+    unsigned *sqMask = nullptr;
+
+    unsigned *sqArray = nullptr;
+
+    unsigned *cqHead = nullptr;
+
+    unsigned *cqTail = nullptr;
+
+    unsigned *cqMask = nullptr;
+
+    io_uring_cqe *cqes = nullptr;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqRing != MAP_FAILED) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+/*!
+ * @brief 一次定位读取，短读时从已读到的位置继续提交，直到读满或到达文件末尾
+ */
+struct IoUringQueue::Request {
+    int fd;
+
+    int64_t offset;
+
+    int64_t length;
+
+    int64_t done;
+
+    QByteArray data;
+
+    iovec vector;
+
+    Completion completion;
+};
+#else
+struct IoUringQueue::Ring {
+};
+
+struct IoUringQueue::Request {
+};
+#endif
+
+IoUringQueue::IoUringQueue() = default;
+
+IoUringQueue::~IoUringQueue() = default;
+
+/*!
+ * @brief 第一次调用时创建队列与完成线程，创建失败后不再重试
+ */
+IoUringQueue *IoUringQueue::instance() {
+    static IoUringQueue *queue = [] {
+        auto *created = new IoUringQueue;
+        if (!created->initialize()) {
+            delete created;
+            return static_cast<IoUringQueue *>(nullptr);
+        }
+        QThread *thread = QThread::create([created]() { created->run(); });
+        thread->start();
+        return created;
+    }();
+    return queue;
+}
+
+#ifdef ASTRAPLAY_IO_URING
+
+/*!
+ * @brief 创建io_uring并映射两个队列，内核不支持或被seccomp等禁用时失败
+ */
+bool IoUringQueue::initialize() {
+    io_uring_params params{};
+    const long fd = syscall(__NR_io_uring_setup, queueDepth, &params);
+    if (fd < 0) {
+        return false;
+    }
+    ring = std::make_unique<Ring>();
+    ring->fd = static_cast<int>(fd);
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                        IORING_OFF_SQ_RING);
+    ring->cqRing = mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                        IORING_OFF_CQ_RING);
+    ring->sqes = static_cast<io_uring_sqe *>(mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+    if (ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        ring.reset();
+        return false;
+    }
+
+    auto *sq = static_cast<char *>(ring->sqRing);
+    auto *cq = static_cast<char *>(ring->cqRing);
+    ring->sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    ring->cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+}
+
+/*!
+ * @brief 提交一次定位读取，队列已满或提交失败时返回false，调用方应改用其他方式读取
+ */
+bool IoUringQueue::submitRead(int fd, int64_t offset, int64_t length, Completion completion) {
+    if (inFlight.fetch_add(1) >= queueDepth) {
+        --inFlight;
+        return false;
+    }
+
+    auto *request = new Request{fd, offset, length, 0, QByteArray(static_cast<int>(length), Qt::Uninitialized),
+                                iovec{}, std::move(completion)};
+    if (!submit(request)) {
+        delete request;
+        --inFlight;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * @brief 将请求中尚未读取的部分写入提交队列并通知内核
+ */
+bool IoUringQueue::submit(Request *request) {
+    QMutexLocker locker(&submitMutex);
+    request->vector.iov_base = request->data.data() + request->done;
+    request->vector.iov_len = static_cast<size_t>(request->length - request->done);
+
+    /*!
+     * @brief 提交队列只由持有submitMutex的线程写入；没有SQPOLL时内核只在io_uring_enter中读取，
+     * 因此提交失败时可以直接回退队尾
+     */
+    const unsigned tail = *ring->sqTail;
+    const unsigned index = tail & *ring->sqMask;
+    io_uring_sqe &sqe = ring->sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = request->fd;
+    sqe.off = static_cast<__u64>(request->offset + request->done);
+    sqe.addr = reinterpret_cast<__u64>(&request->vector);
+    sqe.len = 1;
+    sqe.user_data = reinterpret_cast<__u64>(request);
+    ring->sqArray[index] = index;
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    long submitted;
+    do {
+        submitted = syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, nullptr, 0);
+    } while (submitted < 0 && errno == EINTR);
+    if (submitted != 1) {
+        __atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * @brief 完成线程：等待完成队列，短读时继续提交剩余部分，否则调用完成回调
+ */
+void IoUringQueue::run() {
+    std::vector<io_uring_cqe> completed;
+    for (;;) {
+        const long waited = syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (waited < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            qWarning() << "等待io_uring完成队列失败：" << std::strerror(errno);
+        }
+
+        /*!
+         * @brief 先取出所有完成项并归还队列空间，再处理，处理中重新提交不会与完成队列争用
+         */
+        unsigned head = *ring->cqHead;
+        const unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+        completed.clear();
+        for (; head != tail; ++head) {
+            completed.push_back(ring->cqes[head & *ring->cqMask]);
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+
+        for (const io_uring_cqe &cqe: completed) {
+            auto *request = reinterpret_cast<Request *>(cqe.user_data);
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                if (!submit(request)) {
+                    finish(request, -1);
+                }
+            } else if (cqe.res < 0) {
+                finish(request, -1);
+            } else if (cqe.res == 0) {
+                finish(request, request->done);
+            } else {
+                request->done += cqe.res;
+                if (request->done >= request->length || !submit(request)) {
+                    finish(request, request->done < request->length ? -1 : request->done);
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * @brief 调用完成回调并释放请求
+ */
+void IoUringQueue::finish(Request *request, int64_t count) {
+    request->completion(count, request->data);
+    delete request;
+    --inFlight;
+}
+
+#else
+
+bool IoUringQueue::initialize() {
+    return false;
+}
+
+bool IoUringQueue::submitRead(int, int64_t, int64_t, Completion) {
+    return false;
+}
+
+bool IoUringQueue::submit(Request *) {
+    return false;
+}
+
+void IoUringQueue::run() {
+}
+
+void IoUringQueue::finish(Request *, int64_t) {
+}
+
+#endif
@@ -0,0 +1,156 @@
+#include "local_stream.h"
+#include "mapped_stream.h"
+#include "read_ahead_stream.h"
+#include "archive_index.h"
+
+#include <cstring>
+#include <memory>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+/*!
+ * @brief 本地磁盘上小于该大小的文件仍交给MPV默认的文件流处理
+ */
+static constexpr int64_t minimumLocalStreamSize = 256LL * 1024 * 1024;
+
+/*!
+ * @brief 注册astra://与archive://协议
+ */
+void LocalStream::registerProtocol(mpv_handle *mpv) {
+    if (mpv_stream_cb_add_ro(mpv, protocol, nullptr, &LocalStream::onOpen) < 0) {
+        qWarning() << "注册astra://协议失败";
+    }
+    if (mpv_stream_cb_add_ro(mpv, ArchiveIndex::protocol, nullptr, &LocalStream::onOpenArchive) < 0) {
+        qWarning() << "注册archive://协议失败";
+    }
+}
+
+/*!
+ * @brief 判断文件是否通过astra://协议读取：网络挂载的文件，或本地磁盘上的大文件
+ */
+bool LocalStream::isSuitable(const QString &path) {
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        return false;
+    }
+    return isNetworkPath(path) || info.size() >= minimumLocalStreamSize;
+}
+
+/*!
+ * @brief 判断文件是否位于网络存储上（NAS、SMB共享、NFS挂载等）
+ */
+bool LocalStream::isNetworkPath(const QString &path) {
+#if defined(Q_OS_WIN)
+    /*!
+     * @brief UNC路径或映射的网络驱动器
+     */
+    const QString nativePath = QFileInfo(path).absoluteFilePath();
+    if (nativePath.startsWith("//") || nativePath.startsWith("\\\\")) {
+        return true;
+    }
+    const std::wstring root = nativePath.left(3).toStdWString();
+    return GetDriveTypeW(root.c_str()) == DRIVE_REMOTE;
+#else
+    const QByteArray type = QStorageInfo(path).fileSystemType();
+    return type.startsWith("nfs") || type == "cifs" || type.startsWith("smb") || type == "9p" ||
+           type == "fuse.sshfs" || type == "afs";
+#endif
+}
+
+/*!
+ * @brief 生成astra://协议的地址
+ */
+QString LocalStream::toUri(const QString &path) {
+    return QString(protocol) + "://" + path;
+}
+
+/*!
+ * @brief 打开文件中[offset, offset + length)一段，根据文件所在存储选择读取方式，length为-1时读到文件末尾
+ */
+int LocalStream::openStream(const QString &path, int64_t offset, int64_t length, mpv_stream_cb_info *info) {
+    std::unique_ptr<LocalStream> stream;
+    if (!isNetworkPath(path)) {
+        stream = std::make_unique<MappedStream>(path, offset, length);
+        if (!stream->open()) {
+            stream.reset();
+        }
+    }
+
+    /*!
+     * @brief 网络文件或无法映射的文件使用异步预读
+     */
+    if (!stream) {
+        stream = std::make_unique<ReadAheadStream>(path, offset, length);
+        if (!stream->open()) {
+            qWarning() << "无法打开文件：" << path;
+            return MPV_ERROR_LOADING_FAILED;
+        }
+    }
+
+    info->cookie = stream.release();
+    info->read_fn = &LocalStream::onRead;
+    info->seek_fn = &LocalStream::onSeek;
+    info->size_fn = &LocalStream::onSize;
+    info->close_fn = &LocalStream::onClose;
+    info->cancel_fn = &LocalStream::onCancel;
+    return 0;
+}
+
+/*!
+ * @brief MPV打开astra://地址时调用
+ */
+int LocalStream::onOpen(void *userData, char *uri, mpv_stream_cb_info *info) {
+    Q_UNUSED(userData)
+
+    /*!
+     * @brief 去掉协议前缀得到本地路径
+     */
+    const QString path = QString::fromUtf8(uri).mid(static_cast<int>(std::strlen(protocol)) + 3);
+    return openStream(path, 0, -1, info);
+}
+
+/*!
+ * @brief MPV打开archive://地址时调用，从缓存的索引中查找成员并直接读取其所在的一段
+ */
+int LocalStream::onOpenArchive(void *userData, char *uri, mpv_stream_cb_info *info) {
+    Q_UNUSED(userData)
+
+    QString archivePath, member;
+    if (!ArchiveIndex::parseUri(QString::fromUtf8(uri), &archivePath, &member)) {
+        return MPV_ERROR_LOADING_FAILED;
+    }
+
+    const QSharedPointer<const ArchiveIndex> index = ArchiveIndex::load(archivePath);
+    const ArchiveEntry *entry = index ? index->find(member) : nullptr;
+    if (!entry) {
+        qWarning() << "归档中不存在成员：" << member;
+        return MPV_ERROR_LOADING_FAILED;
+    }
+    if (!entry->stored) {
+        qWarning() << "归档成员经过压缩，无法直接播放：" << member;
+        return MPV_ERROR_UNSUPPORTED;
+    }
+    return openStream(archivePath, entry->offset, entry->size, info);
+}
+
+int64_t LocalStream::onRead(void *cookie, char *buffer, uint64_t bytes) {
+    return static_cast<LocalStream *>(cookie)->read(buffer, bytes);
+}
+
+int64_t LocalStream::onSeek(void *cookie, int64_t offset) {
+    return static_cast<LocalStream *>(cookie)->seek(offset);
+}
+
+int64_t LocalStream::onSize(void *cookie) {
+    return static_cast<LocalStream *>(cookie)->size();
+}
+
+void LocalStream::onClose(void *cookie) {
+    delete static_cast<LocalStream *>(cookie);
+}
+
+void LocalStream::onCancel(void *cookie) {
+    static_cast<LocalStream *>(cookie)->cancel();
+}
@@ -0,0 +1,168 @@
+#include "log_viewer.h"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDir>
+#include <QDateTime>
+#include <QScrollBar>
+#include <QFontDatabase>
+
+/*!
+ * @brief 可选的日志级别，与mpv_request_log_messages的取值对应
+ */
+static const QList<QPair<const char *, mpv_log_level>> logLevels = {
+        {"error", MPV_LOG_LEVEL_ERROR},
+        {"warn",  MPV_LOG_LEVEL_WARN},
+        {"info",  MPV_LOG_LEVEL_INFO},
+        {"v",     MPV_LOG_LEVEL_V},
+        {"debug", MPV_LOG_LEVEL_DEBUG},
+        {"trace", MPV_LOG_LEVEL_TRACE}
+};
+
+LogViewer::LogViewer(Controller *controller, QWidget *parent)
+        : QWidget(parent, Qt::Window), controller(controller), levelComboBox(new QComboBox(this)),
+          moduleLineEdit(new QLineEdit(this)), textEdit(new QPlainTextEdit(this)), maximumLevel(MPV_LOG_LEVEL_INFO),
+          lastSequence(0) {
+    setWindowTitle(tr("MPV日志"));
+    resize(800, 500);
+
+    /*!
+     * @brief 过滤条件与导出按钮
+     */
+    for (const auto &level: logLevels) {
+        levelComboBox->addItem(QString::fromLatin1(level.first), static_cast<int>(level.second));
+    }
+    levelComboBox->setCurrentText(controller->getLogLevel());
+    maximumLevel = static_cast<mpv_log_level>(levelComboBox->currentData().toInt());
+    moduleLineEdit->setPlaceholderText(tr("模块，多个以逗号分隔，如 ffmpeg,vd,cache"));
+    moduleLineEdit->setClearButtonEnabled(true);
+    auto *exportButton = new QPushButton(tr("导出"), this);
+
+    auto *filterLayout = new QHBoxLayout;
+    filterLayout->addWidget(new QLabel(tr("级别"), this));
+    filterLayout->addWidget(levelComboBox);
+    filterLayout->addWidget(new QLabel(tr("模块"), this));
+    filterLayout->addWidget(moduleLineEdit, 1);
+    filterLayout->addWidget(exportButton);
+
+    /*!
+     * @brief 显示的行数与缓冲区容量一致，超出时自动删除最早的行
+     */
+    textEdit->setReadOnly(true);
+    textEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    textEdit->setMaximumBlockCount(MpvLog::capacity);
+    textEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto *layout = new QVBoxLayout(this);
+    layout->addLayout(filterLayout);
+    layout->addWidget(textEdit);
+
+    connect(levelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        maximumLevel = static_cast<mpv_log_level>(levelComboBox->currentData().toInt());
+        this->controller->setLogLevel(levelComboBox->currentText());
+        rebuild();
+    });
+    connect(moduleLineEdit, &QLineEdit::textChanged, this, [this](const QString &text) {
+        modules.clear();
+        for (const QString &module: text.split(',', Qt::SkipEmptyParts)) {
+            modules.append(module.trimmed());
+        }
+        rebuild();
+    });
+    connect(exportButton, &QPushButton::clicked, this, &LogViewer::exportLog);
+
+    refreshTimer.setInterval(refreshInterval);
+    connect(&refreshTimer, &QTimer::timeout, this, &LogViewer::refresh);
+}
+
+/*!
+ * @brief 窗口可见时才刷新
+ */
+void LogViewer::showEvent(QShowEvent *event) {
+    rebuild();
+    refreshTimer.start();
+    QWidget::showEvent(event);
+}
+
+void LogViewer::hideEvent(QHideEvent *event) {
+    refreshTimer.stop();
+    QWidget::hideEvent(event);
+}
+
+/*!
+ * @brief 追加上次刷新之后的新日志，没有新日志时不读取缓冲区
+ */
+void LogViewer::refresh() {
+    const MpvLog &log = controller->getMpvLog();
+    if (log.lastSequence() == lastSequence) {
+        return;
+    }
+
+    QStringList lines;
+    for (const LogRecord &record: log.recordsAfter(lastSequence)) {
+        lastSequence = record.sequence;
+        if (accepts(record)) {
+            lines.append(MpvLog::format(record));
+        }
+    }
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    /*!
+     * @brief 用户向上翻看时不自动滚动到底部
+     */
+    QScrollBar *scrollBar = textEdit->verticalScrollBar();
+    const bool atBottom = scrollBar->value() == scrollBar->maximum();
+    textEdit->appendPlainText(lines.join('\n'));
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
+
+/*!
+ * @brief 过滤条件变化后按缓冲区中的全部日志重新显示
+ */
+void LogViewer::rebuild() {
+    textEdit->clear();
+    lastSequence = 0;
+    refresh();
+}
+
+/*!
+ * @brief 导出缓冲区中的全部日志，不受过滤条件影响
+ */
+void LogViewer::exportLog() {
+    const QString fileName = QFileDialog::getSaveFileName(
+            this, tr("导出MPV日志"),
+            QDir::home().filePath("mpv_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".log"),
+            tr("日志文件 (*.log *.txt)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (!controller->getMpvLog().exportLog(fileName)) {
+        QMessageBox::critical(this, tr("错误"), tr("无法写入日志文件：%1").arg(fileName));
+    }
+}
+
+/*!
+ * @brief 记录是否满足当前的级别与模块过滤条件
+ */
+bool LogViewer::accepts(const LogRecord &record) const {
+    if (record.level > maximumLevel) {
+        return false;
+    }
+    if (modules.isEmpty()) {
+        return true;
+    }
+    const QString prefix = QString::fromUtf8(record.prefix);
+    for (const QString &module: modules) {
+        if (prefix.startsWith(module, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,127 @@
+#include "mapped_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+/*!
+ * @brief 预读窗口大小，读取位置越过窗口一半时向前滑动
+ */
+static constexpr int64_t readAheadWindow = 64LL * 1024 * 1024;
+
+MappedStream::MappedStream(const QString &path, int64_t offset, int64_t length)
+        : file(path), data(nullptr), baseOffset(offset), length(length), fileSize(0), position(0), windowEnd(0) {}
+
+MappedStream::~MappedStream() {
+    if (data) {
+        file.unmap(data);
+    }
+}
+
+/*!
+ * @brief 打开并映射整个文件，或文件中[baseOffset, baseOffset + length)一段
+ */
+bool MappedStream::open() {
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    fileSize = file.size() - baseOffset;
+    if (length >= 0) {
+        fileSize = std::min(fileSize, length);
+    }
+    if (baseOffset < 0 || fileSize <= 0) {
+        return false;
+    }
+
+    data = file.map(baseOffset, fileSize);
+    if (!data) {
+        return false;
+    }
+
+#if defined(Q_OS_UNIX)
+    /*!
+     * @brief 媒体文件以顺序读取为主，允许内核加大预读并及早回收已读页面
+     */
+    static const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+    const auto start = reinterpret_cast<uintptr_t>(data);
+    posix_madvise(reinterpret_cast<void *>(start - start % pageSize),
+                  static_cast<size_t>(fileSize) + start % pageSize, POSIX_MADV_SEQUENTIAL);
+#endif
+    adviseWindow(0);
+    return true;
+}
+
+/*!
+ * @brief 从映射区域拷贝数据
+ */
+int64_t MappedStream::read(char *buffer, uint64_t bytes) {
+    if (position >= fileSize) {
+        return 0;
+    }
+
+    const int64_t count = std::min<int64_t>(static_cast<int64_t>(bytes), fileSize - position);
+
+    /*!
+     * @brief 读取位置越过预读窗口的一半时，继续提示后续区域
+     */
+    if (position + count > windowEnd - readAheadWindow / 2) {
+        adviseWindow(position);
+    }
+
+    std::memcpy(buffer, data + position, static_cast<size_t>(count));
+    position += count;
+    return count;
+}
+
+/*!
+ * @brief 跳转读取位置，并立即为新位置预读
+ */
+int64_t MappedStream::seek(int64_t offset) {
+    if (offset < 0 || offset > fileSize) {
+        return MPV_ERROR_GENERIC;
+    }
+
+    position = offset;
+    if (position < windowEnd - readAheadWindow || position >= windowEnd - readAheadWindow / 2) {
+        adviseWindow(position);
+    }
+    return position;
+}
+
+/*!
+ * @brief 提示系统预读[offset, offset + readAheadWindow)区域
+ */
+void MappedStream::adviseWindow(int64_t offset) {
+    const int64_t end = std::min(offset + readAheadWindow, fileSize);
+    windowEnd = end;
+
+#if defined(Q_OS_UNIX)
+    /*!
+     * @brief posix_madvise要求起始地址按页对齐，映射文件中的一段时data本身不一定对齐
+     */
+    static const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+    const auto start = reinterpret_cast<uintptr_t>(data + offset);
+    const uintptr_t alignedStart = start - start % pageSize;
+    posix_madvise(reinterpret_cast<void *>(alignedStart),
+                  static_cast<size_t>(reinterpret_cast<uintptr_t>(data + end) - alignedStart), POSIX_MADV_WILLNEED);
+#elif defined(Q_OS_WIN) && _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = data + offset;
+    range.NumberOfBytes = static_cast<SIZE_T>(end - offset);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#endif
+}
+
+/*!
+ * @brief 返回文件大小
+ */
+int64_t MappedStream::size() const {
+    return fileSize;
+}
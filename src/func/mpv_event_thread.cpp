@@ -0,0 +1,155 @@
+#include "mpv_event_thread.h"
+
+#include <utility>
+
+#include "mpv/qthelper.hpp"
+#include "trace.h"
+
+MpvEventThread::MpvEventThread(mpv_handle *mpv, BatchReady batchReady)
+        : mpv(mpv), batchReady(std::move(batchReady)), thread(nullptr), stopping(false) {}
+
+MpvEventThread::~MpvEventThread() {
+    stop();
+
+    /*!
+     * @brief 释放未被取走的事件所持有的节点
+     */
+    MpvEvent event;
+    while (queue.pop(event)) {
+        delete event.node;
+    }
+}
+
+/*!
+ * @brief 设置日志回调，须在start()之前调用
+ */
+void MpvEventThread::setLogHandler(LogHandler handler) {
+    logHandler = std::move(handler);
+}
+
+/*!
+ * @brief 启动事件线程，须在设置好监听属性后调用
+ */
+void MpvEventThread::start() {
+    if (thread) {
+        return;
+    }
+    thread = QThread::create([this]() { run(); });
+    thread->start();
+}
+
+/*!
+ * @brief 停止事件线程并等待其退出，须在销毁MPV实例之前调用
+ */
+void MpvEventThread::stop() {
+    if (!thread) {
+        return;
+    }
+    stopping = true;
+    mpv_wakeup(mpv);
+    thread->wait();
+    delete thread;
+    thread = nullptr;
+}
+
+/*!
+ * @brief 在主线程中取出一个事件，队列为空时返回false
+ */
+bool MpvEventThread::pop(MpvEvent &event) {
+    return queue.pop(event);
+}
+
+/*!
+ * @brief 事件循环：阻塞等待第一个事件，再不等待地取空MPV事件队列，整批只通知一次
+ */
+void MpvEventThread::run() {
+    Trace::setThreadName("mpv events");
+    while (!stopping) {
+        const mpv_event *event = mpv_wait_event(mpv, -1);
+        bool pushed = false;
+        while (event->event_id != MPV_EVENT_NONE) {
+            if (event->event_id == MPV_EVENT_SHUTDOWN) {
+                stopping = true;
+                break;
+            }
+            Trace::instant("mpv event", "mpv", mpv_event_name(event->event_id));
+            if (event->event_id == MPV_EVENT_LOG_MESSAGE) {
+                if (logHandler) {
+                    logHandler(static_cast<const mpv_event_log_message *>(event->data));
+                }
+            } else {
+                enqueue(decode(event));
+                pushed = true;
+            }
+            event = mpv_wait_event(mpv, 0);
+        }
+        if (pushed && batchReady) {
+            batchReady();
+        }
+    }
+}
+
+/*!
+ * @brief 把MPV事件解码为定长事件，event->data在下一次mpv_wait_event后失效，所需数据须在此复制
+ */
+MpvEvent MpvEventThread::decode(const mpv_event *event) {
+    MpvEvent result;
+    result.id = event->event_id;
+    result.error = event->error;
+    result.replyUserdata = event->reply_userdata;
+
+    switch (event->event_id) {
+        case MPV_EVENT_PROPERTY_CHANGE: {
+            const auto *property = static_cast<const mpv_event_property *>(event->data);
+            result.format = property->data ? property->format : MPV_FORMAT_NONE;
+            switch (result.format) {
+                case MPV_FORMAT_DOUBLE:
+                    result.number = *static_cast<const double *>(property->data);
+                    break;
+                case MPV_FORMAT_FLAG:
+                    result.integer = *static_cast<const int *>(property->data);
+                    break;
+                case MPV_FORMAT_INT64:
+                    result.integer = *static_cast<const int64_t *>(property->data);
+                    break;
+                case MPV_FORMAT_NODE:
+                    result.node = new QVariant(mpv::qt::node_to_variant(static_cast<mpv_node *>(property->data)));
+                    break;
+                case MPV_FORMAT_STRING:
+                    result.node = new QVariant(QString::fromUtf8(*static_cast<char **>(property->data)));
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        case MPV_EVENT_COMMAND_REPLY:
+            if (event->error >= 0) {
+                auto *command = static_cast<mpv_event_command *>(event->data);
+                result.node = new QVariant(mpv::qt::node_to_variant(&command->result));
+            }
+            break;
+        case MPV_EVENT_END_FILE:
+            result.integer = static_cast<const mpv_event_end_file *>(event->data)->reason;
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+/*!
+ * @brief 写入队列；主线程处理不过来导致队列已满时短暂等待，回复事件不能丢弃
+ */
+void MpvEventThread::enqueue(const MpvEvent &event) {
+    while (!queue.push(event)) {
+        if (stopping) {
+            delete event.node;
+            return;
+        }
+        if (batchReady) {
+            batchReady();
+        }
+        QThread::usleep(500);
+    }
+}
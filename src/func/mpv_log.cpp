@@ -0,0 +1,116 @@
+#include "mpv_log.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+MpvLog::MpvLog() : records(capacity), written(0) {}
+
+/*!
+ * @brief 追加一条日志，缓冲区已满时覆盖最旧的记录
+ */
+void MpvLog::append(const mpv_event_log_message *message) {
+    const qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    QMutexLocker locker(&mutex);
+    const uint64_t sequence = written.load(std::memory_order_relaxed) + 1;
+    LogRecord &record = records[sequence % capacity];
+    record.sequence = sequence;
+    record.timestamp = timestamp;
+    record.level = message->log_level;
+    std::strncpy(record.prefix, message->prefix, sizeof(record.prefix) - 1);
+    record.prefix[sizeof(record.prefix) - 1] = '\0';
+
+    /*!
+     * @brief MPV的日志文本以换行结尾，存储时去掉
+     */
+    size_t length = std::strlen(message->text);
+    while (length > 0 && (message->text[length - 1] == '\n' || message->text[length - 1] == '\r')) {
+        --length;
+    }
+    length = std::min(length, sizeof(record.text) - 1);
+    std::memcpy(record.text, message->text, length);
+    record.text[length] = '\0';
+
+    written.store(sequence, std::memory_order_release);
+}
+
+/*!
+ * @brief 最近写入记录的序号，没有记录时为0，可用于判断是否有新日志而无需加锁
+ */
+uint64_t MpvLog::lastSequence() const {
+    return written.load(std::memory_order_acquire);
+}
+
+/*!
+ * @brief 取出序号大于sequence且仍保留在缓冲区中的记录，按写入顺序排列
+ */
+QVector<LogRecord> MpvLog::recordsAfter(uint64_t sequence) const {
+    QMutexLocker locker(&mutex);
+    const uint64_t last = written.load(std::memory_order_relaxed);
+    const uint64_t oldest = last > static_cast<uint64_t>(capacity) ? last - capacity + 1 : 1;
+    const uint64_t first = std::max(sequence + 1, oldest);
+
+    QVector<LogRecord> result;
+    if (first > last) {
+        return result;
+    }
+    result.reserve(static_cast<int>(last - first + 1));
+    for (uint64_t i = first; i <= last; ++i) {
+        result.append(records[i % capacity]);
+    }
+    return result;
+}
+
+/*!
+ * @brief 导出缓冲区中的全部日志
+ */
+bool MpvLog::exportLog(const QString &fileName) const {
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    for (const LogRecord &record: recordsAfter(0)) {
+        file.write(format(record).toUtf8());
+        file.write("\n");
+    }
+    return file.commit();
+}
+
+/*!
+ * @brief 格式化为一行文本
+ */
+QString MpvLog::format(const LogRecord &record) {
+    return QString("%1 [%2] %3: %4")
+            .arg(QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("hh:mm:ss.zzz"),
+                 QString::fromLatin1(levelName(record.level)),
+                 QString::fromUtf8(record.prefix),
+                 QString::fromUtf8(record.text));
+}
+
+/*!
+ * @brief 日志级别名称，与mpv_request_log_messages接受的取值一致
+ */
+const char *MpvLog::levelName(mpv_log_level level) {
+    switch (level) {
+        case MPV_LOG_LEVEL_FATAL:
+            return "fatal";
+        case MPV_LOG_LEVEL_ERROR:
+            return "error";
+        case MPV_LOG_LEVEL_WARN:
+            return "warn";
+        case MPV_LOG_LEVEL_INFO:
+            return "info";
+        case MPV_LOG_LEVEL_V:
+            return "v";
+        case MPV_LOG_LEVEL_DEBUG:
+            return "debug";
+        case MPV_LOG_LEVEL_TRACE:
+            return "trace";
+        default:
+            return "no";
+    }
+}
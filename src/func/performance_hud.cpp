@@ -0,0 +1,129 @@
+#include "performance_hud.h"
+
+/*!
+ * @brief 各统计项对应的属性与格式，顺序与Statistic一致
+ */
+static const struct {
+    const char *name;
+    mpv_format format;
+} statistics[] = {
+        {"frame-drop-count",         MPV_FORMAT_INT64},
+        {"decoder-frame-drop-count", MPV_FORMAT_INT64},
+        {"vo-delayed-frame-count",   MPV_FORMAT_INT64},
+        {"estimated-vf-fps",         MPV_FORMAT_DOUBLE},
+        {"avsync",                   MPV_FORMAT_DOUBLE},
+        {"demuxer-cache-duration",   MPV_FORMAT_DOUBLE},
+        {"hwdec-current",            MPV_FORMAT_STRING},
+        {"vd-lavc-threads",          MPV_FORMAT_INT64}
+};
+
+PerformanceHud::PerformanceHud(Controller *controller, QObject *parent)
+        : QObject(parent), controller(controller), visible(false) {
+    /*!
+     * @brief avsync等属性每帧都会变化，变化只标记待刷新，由单次定时器合并为一次绘制
+     */
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(refreshInterval);
+    connect(&refreshTimer, &QTimer::timeout, this, &PerformanceHud::render);
+    connect(controller, &Controller::observedPropertyChanged, this, &PerformanceHud::onPropertyChanged);
+}
+
+PerformanceHud::~PerformanceHud() {
+    setVisible(false);
+}
+
+bool PerformanceHud::isVisible() const {
+    return visible;
+}
+
+/*!
+ * @brief 显示或隐藏叠加层，显示期间才监听属性
+ */
+void PerformanceHud::setVisible(bool show) {
+    if (show == visible) {
+        return;
+    }
+    visible = show;
+
+    mpv_handle *mpv = controller->getMpvInstance();
+    if (visible) {
+        for (int i = 0; i < StatisticCount; ++i) {
+            values[i].clear();
+            mpv_observe_property(mpv, statisticBase + i, statistics[i].name, statistics[i].format);
+        }
+        render();
+    } else {
+        refreshTimer.stop();
+        for (int i = 0; i < StatisticCount; ++i) {
+            mpv_unobserve_property(mpv, statisticBase + i);
+        }
+        controller->commandAsync({"osd-overlay", QString::number(overlayId), "none", ""});
+    }
+}
+
+/*!
+ * @brief 记录属性的新值，等待合并刷新
+ */
+void PerformanceHud::onPropertyChanged(const MpvEvent &event) {
+    if (!visible || event.replyUserdata < statisticBase || event.replyUserdata >= statisticBase + StatisticCount) {
+        return;
+    }
+
+    QVariant &target = values[event.replyUserdata - statisticBase];
+    switch (event.format) {
+        case MPV_FORMAT_DOUBLE:
+            target = event.number;
+            break;
+        case MPV_FORMAT_INT64:
+            target = static_cast<qlonglong>(event.integer);
+            break;
+        case MPV_FORMAT_STRING:
+            target = event.node ? *event.node : QVariant();
+            break;
+        default:
+            target.clear();
+            break;
+    }
+
+    if (!refreshTimer.isActive()) {
+        refreshTimer.start();
+    }
+}
+
+/*!
+ * @brief 以ASS格式绘制到画面左上角
+ */
+void PerformanceHud::render() {
+    if (!visible) {
+        return;
+    }
+
+    const QString threads = values[DecoderThreads].isValid() && values[DecoderThreads].toLongLong() == 0
+                            ? tr("自动") : value(DecoderThreads);
+    const QStringList lines = {
+            tr("丢帧（输出/解码）：%1 / %2").arg(value(FrameDropCount), value(DecoderFrameDropCount)),
+            tr("延迟帧：%1").arg(value(DelayedFrameCount)),
+            tr("输出帧率：%1").arg(value(EstimatedFps, 3)),
+            tr("音画同步：%1 秒").arg(value(AvSync, 3)),
+            tr("缓存时长：%1 秒").arg(value(CacheDuration, 1)),
+            tr("硬件解码：%1").arg(value(HwdecCurrent)),
+            tr("解码线程：%1").arg(threads)
+    };
+
+    const QString data = "{\\an7\\fs24\\bord2\\3c&H000000&\\1c&HFFFFFF&}" + lines.join("\\N");
+    controller->commandAsync({"osd-overlay", QString::number(overlayId), "ass-events", data, "0", "720"});
+}
+
+/*!
+ * @brief 格式化统计值，属性不可用时显示“-”
+ */
+QString PerformanceHud::value(Statistic statistic, int precision) const {
+    const QVariant &variant = values[statistic];
+    if (!variant.isValid()) {
+        return "-";
+    }
+    if (variant.type() == QVariant::Double) {
+        return QString::number(variant.toDouble(), 'f', precision);
+    }
+    return variant.toString();
+}
@@ -0,0 +1,173 @@
+#include "player_widget.h"
+
+PlayerWidget::PlayerWidget(QWidget *parent)
+        : QOpenGLWidget(parent), mpv(nullptr), mpvGL(nullptr), pendingPresent(false), pendingTiming() {
+    qRegisterMetaType<FrameTiming>();
+
+    /*!
+     * @brief 缓冲区交换完成后回报MPV，并记录该帧的呈现时间
+     */
+    connect(this, &QOpenGLWidget::frameSwapped, this, &PlayerWidget::handleFrameSwapped);
+}
+
+PlayerWidget::~PlayerWidget() {
+    releaseRenderContext();
+}
+
+/*!
+ * @brief 绑定MPV实例，若OpenGL上下文已就绪则立即创建渲染上下文
+ */
+void PlayerWidget::setMpvInstance(mpv_handle *handle) {
+    releaseRenderContext();
+    mpv = handle;
+
+    if (mpv && context()) {
+        makeCurrent();
+        createRenderContext();
+        doneCurrent();
+    }
+}
+
+/*!
+ * @brief 释放渲染上下文，必须在MPV实例销毁之前调用
+ */
+void PlayerWidget::releaseRenderContext() {
+    if (mpvGL) {
+        makeCurrent();
+        mpv_render_context_free(mpvGL);
+        mpvGL = nullptr;
+        doneCurrent();
+    }
+}
+
+void PlayerWidget::initializeGL() {
+    /*!
+     * @brief 控件移动到其他顶级窗口时OpenGL上下文会被重建，需先释放旧的渲染上下文
+     */
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, &PlayerWidget::releaseRenderContext,
+            Qt::UniqueConnection);
+
+    if (mpv) {
+        createRenderContext();
+    }
+}
+
+void PlayerWidget::paintGL() {
+    TRACE_FUNCTION("render");
+
+    if (!mpvGL) {
+        return;
+    }
+
+    /*!
+     * @brief 获取即将渲染的帧信息
+     */
+    mpv_render_frame_info frameInfo{0, 0};
+    mpv_render_param infoParam{MPV_RENDER_PARAM_NEXT_FRAME_INFO, &frameInfo};
+    mpv_render_context_get_info(mpvGL, infoParam);
+
+    /*!
+     * @brief 渲染到QOpenGLWidget的默认帧缓冲
+     */
+    const qreal ratio = devicePixelRatioF();
+    mpv_opengl_fbo fbo{static_cast<int>(defaultFramebufferObject()), static_cast<int>(width() * ratio),
+                       static_cast<int>(height() * ratio), 0};
+    int flipY = 0;
+    mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_OPENGL_FBO, &fbo},
+            {MPV_RENDER_PARAM_FLIP_Y,     &flipY},
+            {MPV_RENDER_PARAM_INVALID,    nullptr}
+    };
+
+    const int64_t renderStart = mpv_get_time_us(mpv);
+    mpv_render_context_render(mpvGL, params);
+
+    /*!
+     * @brief 记录本帧信息，待缓冲区交换完成后补全呈现时间
+     */
+    if (frameInfo.flags & MPV_RENDER_FRAME_INFO_PRESENT) {
+        pendingTiming.targetTime = frameInfo.target_time;
+        pendingTiming.renderTime = mpv_get_time_us(mpv) - renderStart;
+        pendingTiming.redraw = (frameInfo.flags & MPV_RENDER_FRAME_INFO_REDRAW) != 0;
+        pendingTiming.repeat = (frameInfo.flags & MPV_RENDER_FRAME_INFO_REPEAT) != 0;
+        pendingPresent = true;
+    }
+}
+
+/*!
+ * @brief 提供OpenGL函数地址给MPV
+ */
+void *PlayerWidget::getProcAddress(void *ctx, const char *name) {
+    Q_UNUSED(ctx)
+    QOpenGLContext *glContext = QOpenGLContext::currentContext();
+    if (!glContext) {
+        return nullptr;
+    }
+    return reinterpret_cast<void *>(glContext->getProcAddress(QByteArray(name)));
+}
+
+/*!
+ * @brief MPV渲染更新回调，可能在任意线程中被调用，只负责投递到主线程
+ */
+void PlayerWidget::onMpvRenderUpdate(void *ctx) {
+    QMetaObject::invokeMethod(static_cast<PlayerWidget *>(ctx), &PlayerWidget::handleRenderUpdate,
+                              Qt::QueuedConnection);
+}
+
+/*!
+ * @brief 创建MPV的OpenGL渲染上下文，调用时OpenGL上下文必须为当前上下文
+ */
+void PlayerWidget::createRenderContext() {
+    if (mpvGL) {
+        return;
+    }
+
+    mpv_opengl_init_params glInitParams{&PlayerWidget::getProcAddress, nullptr};
+    mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_API_TYPE,           const_cast<char *>(MPV_RENDER_API_TYPE_OPENGL)},
+            {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, &glInitParams},
+            {MPV_RENDER_PARAM_INVALID,            nullptr}
+    };
+
+    if (mpv_render_context_create(&mpvGL, mpv, params) < 0) {
+        mpvGL = nullptr;
+        qWarning() << "MPV渲染上下文创建失败";
+        return;
+    }
+
+    mpv_render_context_set_update_callback(mpvGL, &PlayerWidget::onMpvRenderUpdate, this);
+}
+
+/*!
+ * @brief 仅在有新帧需要绘制时请求重绘
+ */
+void PlayerWidget::handleRenderUpdate() {
+    if (!mpvGL) {
+        return;
+    }
+
+    if (mpv_render_context_update(mpvGL) & MPV_RENDER_UPDATE_FRAME) {
+        update();
+    }
+}
+
+/*!
+ * @brief 缓冲区交换完成
+ */
+void PlayerWidget::handleFrameSwapped() {
+    if (!mpvGL) {
+        return;
+    }
+
+    /*!
+     * @brief 通知MPV已完成交换，用于其内部的帧计时
+     */
+    mpv_render_context_report_swap(mpvGL);
+
+    if (pendingPresent) {
+        pendingPresent = false;
+        pendingTiming.presentTime = mpv_get_time_us(mpv);
+        Trace::instant("frame presented", "render");
+        emit framePresented(pendingTiming);
+    }
+}
@@ -0,0 +1,85 @@
+#include "preview_extractor.h"
+
+PreviewExtractor::PreviewExtractor(QObject *parent) : QObject(parent), width(0), completed(0), succeeded(0) {}
+
+/*!
+ * @brief 开始提取，每个对象只能使用一次
+ */
+void PreviewExtractor::start(const QString &filePath, const QVector<double> &timePoints, const ImageHandler &imageHandler,
+                             int frameWidth) {
+    path = filePath;
+    times = timePoints;
+    handler = imageHandler;
+    width = frameWidth;
+
+    const int count = static_cast<int>(times.size());
+    const int workerCount = qBound(1, defaultWorkerCount(), qMax(1, count));
+
+    /*!
+     * @brief 每个线程负责一段连续的时间点，段内的跳转都是向前的，减少重复解码
+     */
+    pipeline.start(workerCount, [this, count, workerCount](int worker) {
+        runWorker(count * worker / workerCount, count * (worker + 1) / workerCount);
+    }, [this]() {
+        emit finished(succeeded, pipeline.isCancelled());
+    }, QThread::LowPriority);
+}
+
+/*!
+ * @brief 取消提取，已经在途的取帧立即中断
+ */
+void PreviewExtractor::cancel() {
+    pipeline.cancel();
+}
+
+/*!
+ * @brief 取帧线程数：每个线程都有独立的解码器，线程数过多反而与主播放器争抢CPU
+ */
+int PreviewExtractor::defaultWorkerCount() {
+    return qBound(1, QThread::idealThreadCount() / 2, 4);
+}
+
+/*!
+ * @brief 取帧线程：依次取[first, last)的时间点并提交到线程池处理
+ */
+void PreviewExtractor::runWorker(int first, int last) {
+    FrameGrabber grabber(width);
+    pipeline.attach(&grabber);
+
+    int next = first;
+    if (grabber.open(path)) {
+        for (; next < last && !pipeline.isCancelled(); ++next) {
+            const QImage image = grabber.grab(times[next]);
+            if (image.isNull()) {
+                taskDone(false);
+                continue;
+            }
+
+            const int index = next;
+            const double time = grabber.getTimePos();
+            pipeline.submit([this, index, time, image]() {
+                taskDone(!pipeline.isCancelled() && handler(index, time, image));
+            });
+        }
+    }
+
+    /*!
+     * @brief 文件无法打开时，本段剩余的时间点都记为失败
+     */
+    if (!pipeline.isCancelled()) {
+        for (; next < last; ++next) {
+            taskDone(false);
+        }
+    }
+    pipeline.detach(&grabber);
+}
+
+/*!
+ * @brief 记录一张图像的结果并报告进度
+ */
+void PreviewExtractor::taskDone(bool ok) {
+    if (ok) {
+        ++succeeded;
+    }
+    emit progressChanged(++completed, static_cast<int>(times.size()));
+}
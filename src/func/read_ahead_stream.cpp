@@ -0,0 +1,352 @@
+#include "read_ahead_stream.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+#include "io_uring_queue.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * @brief 单次预读的块大小
+ */
+static constexpr int64_t blockSize = 1024 * 1024;
+
+/*!
+ * @brief 读取位置之前保持的预读块数
+ */
+static constexpr size_t pipelineDepth = 16;
+
+namespace {
+    /*!
+     * @brief 预读块
+     */
+    struct Block {
+        int64_t offset;
+        QByteArray data;
+        bool ready;
+        bool failed;
+    };
+}
+
+/*!
+ * @brief 与线程池中的读取任务共享的状态，最后一个任务结束后才释放文件句柄
+ */
+struct ReadAheadStream::State {
+    QMutex mutex;
+
+    QWaitCondition blockReady;
+
+    std::deque<Block> blocks;
+
+    quint64 generation = 0;
+
+    bool cancelled = false;
+
+#if defined(Q_OS_WIN)
+    HANDLE handle = INVALID_HANDLE_VALUE;
+
+    ~State() {
+        if (handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(handle);
+        }
+    }
+#else
+    int handle = -1;
+
+    ~State() {
+        if (handle >= 0) {
+            ::close(handle);
+        }
+    }
+#endif
+
+    /*!
+     * @brief 在指定位置读取，不改变文件指针，可在多个线程中并发调用
+     */
+    int64_t positionalRead(char *buffer, int64_t length, int64_t offset) const {
+        int64_t total = 0;
+        while (total < length) {
+#if defined(Q_OS_WIN)
+            /*!
+             * @brief 句柄以重叠方式打开，多个线程的读取可同时在途，否则系统会将同一句柄上的读取串行化
+             */
+            OVERLAPPED overlapped{};
+            const int64_t current = offset + total;
+            overlapped.Offset = static_cast<DWORD>(current & 0xFFFFFFFF);
+            overlapped.OffsetHigh = static_cast<DWORD>(current >> 32);
+            overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            DWORD count = 0;
+            BOOL ok = ReadFile(handle, buffer + total, static_cast<DWORD>(length - total), nullptr, &overlapped);
+            if (ok || GetLastError() == ERROR_IO_PENDING) {
+                ok = GetOverlappedResult(handle, &overlapped, &count, TRUE);
+            }
+            const DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+            CloseHandle(overlapped.hEvent);
+            if (!ok) {
+                return error == ERROR_HANDLE_EOF ? total : -1;
+            }
+#else
+            const ssize_t count = ::pread(handle, buffer + total, static_cast<size_t>(length - total),
+                                          static_cast<off_t>(offset + total));
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+#endif
+            if (count == 0) {
+                break;
+            }
+            total += static_cast<int64_t>(count);
+        }
+        return total;
+    }
+};
+
+ReadAheadStream::ReadAheadStream(const QString &path, int64_t offset, int64_t length)
+        : path(path), state(std::make_shared<State>()), baseOffset(offset), length(length), fileSize(0), position(0) {}
+
+ReadAheadStream::~ReadAheadStream() {
+    /*!
+     * @brief 作废所有未完成的读取，任务结束后由共享状态自行释放
+     */
+    QMutexLocker locker(&state->mutex);
+    state->cancelled = true;
+    ++state->generation;
+    state->blocks.clear();
+}
+
+/*!
+ * @brief 打开文件并开始预读文件头部
+ */
+bool ReadAheadStream::open() {
+#if defined(Q_OS_WIN)
+    const std::wstring nativePath = path.toStdWString();
+    state->handle = CreateFileW(nativePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+    if (state->handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER nativeSize;
+    if (!GetFileSizeEx(state->handle, &nativeSize)) {
+        return false;
+    }
+    fileSize = nativeSize.QuadPart;
+#else
+    state->handle = ::open(path.toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+    if (state->handle < 0) {
+        return false;
+    }
+    struct stat info{};
+    if (fstat(state->handle, &info) < 0) {
+        return false;
+    }
+    fileSize = static_cast<int64_t>(info.st_size);
+#endif
+
+    /*!
+     * @brief 只读取文件中的一段时，流的大小为该段长度
+     */
+    if (baseOffset > fileSize) {
+        return false;
+    }
+    fileSize -= baseOffset;
+    if (length >= 0) {
+        fileSize = std::min(fileSize, length);
+    }
+
+    QMutexLocker locker(&state->mutex);
+    restartPipeline(0);
+    return true;
+}
+
+/*!
+ * @brief 从已完成的预读块中拷贝数据，所需的块尚未完成时等待其完成
+ */
+int64_t ReadAheadStream::read(char *buffer, uint64_t bytes) {
+    QMutexLocker locker(&state->mutex);
+    if (state->cancelled) {
+        return -1;
+    }
+    if (position >= fileSize) {
+        return 0;
+    }
+
+    /*!
+     * @brief 读取位置不在预读范围内时（如跳转后）重新建立预读队列
+     */
+    if (state->blocks.empty() || position < state->blocks.front().offset ||
+        position >= state->blocks.back().offset + blockSize) {
+        restartPipeline(position);
+    }
+
+    /*!
+     * @brief 丢弃已读过的块并补足预读队列
+     */
+    while (state->blocks.front().offset + blockSize <= position) {
+        state->blocks.pop_front();
+    }
+    fillPipeline();
+
+    /*!
+     * @brief 等待当前块完成，deque在两端增删时不会使其余元素的引用失效
+     */
+    Block &block = state->blocks.front();
+    while (!block.ready && !block.failed && !state->cancelled) {
+        state->blockReady.wait(&state->mutex);
+    }
+    if (block.failed || state->cancelled) {
+        return -1;
+    }
+
+    const int64_t available = block.offset + block.data.size() - position;
+    if (available <= 0) {
+        return 0;
+    }
+    const int64_t count = std::min<int64_t>(available, static_cast<int64_t>(bytes));
+    std::memcpy(buffer, block.data.constData() + (position - block.offset), static_cast<size_t>(count));
+    position += count;
+    return count;
+}
+
+/*!
+ * @brief 跳转读取位置，新位置不在预读范围内时立即从新位置开始预读
+ */
+int64_t ReadAheadStream::seek(int64_t offset) {
+    if (offset < 0 || offset > fileSize) {
+        return MPV_ERROR_GENERIC;
+    }
+
+    QMutexLocker locker(&state->mutex);
+    position = offset;
+    if (state->blocks.empty() || position < state->blocks.front().offset ||
+        position >= state->blocks.back().offset + blockSize) {
+        restartPipeline(position);
+    }
+    return position;
+}
+
+/*!
+ * @brief 返回文件大小
+ */
+int64_t ReadAheadStream::size() const {
+    return fileSize;
+}
+
+/*!
+ * @brief 中断正在等待的读取，由MPV在其他线程中调用
+ */
+void ReadAheadStream::cancel() {
+    QMutexLocker locker(&state->mutex);
+    state->cancelled = true;
+    state->blockReady.wakeAll();
+}
+
+/*!
+ * @brief 作废现有预读块，从offset所在的块开始重新预读，调用时需持有锁
+ */
+void ReadAheadStream::restartPipeline(int64_t offset) {
+    ++state->generation;
+    state->blocks.clear();
+    state->blocks.push_back({offset - offset % blockSize, QByteArray(), false, false});
+    scheduleBlock(state->blocks.back().offset, std::min(blockSize, fileSize - state->blocks.back().offset));
+    fillPipeline();
+}
+
+/*!
+ * @brief 将预读队列补足到pipelineDepth个块，调用时需持有锁
+ */
+void ReadAheadStream::fillPipeline() {
+    int64_t next = state->blocks.back().offset + blockSize;
+    while (state->blocks.size() < pipelineDepth && next < fileSize) {
+        state->blocks.push_back({next, QByteArray(), false, false});
+        scheduleBlock(next, std::min(blockSize, fileSize - next));
+        next += blockSize;
+    }
+}
+
+/*!
+ * @brief 提交一个块的读取，调用时需持有锁。Linux上优先提交到io_uring，在途读取不占用线程；
+ * io_uring不可用或队列已满时，以及其他平台上，提交到线程池中执行定位读取
+ */
+void ReadAheadStream::scheduleBlock(int64_t offset, int64_t length) {
+    std::shared_ptr<State> shared = state;
+    const quint64 generation = state->generation;
+    const int64_t fileOffset = baseOffset + offset;
+
+#if !defined(Q_OS_WIN)
+    IoUringQueue *queue = IoUringQueue::instance();
+    if (queue && queue->submitRead(state->handle, fileOffset, length,
+                                   [shared, offset, generation](int64_t count, QByteArray &data) {
+                                       completeBlock(shared, offset, generation, count, data);
+                                   })) {
+        return;
+    }
+#endif
+
+    readPool()->start([shared, offset, fileOffset, length, generation]() {
+        /*!
+         * @brief 跳转后已作废的任务直接放弃，不再占用带宽
+         */
+        {
+            QMutexLocker locker(&shared->mutex);
+            if (generation != shared->generation || shared->cancelled) {
+                return;
+            }
+        }
+
+        QByteArray data(static_cast<int>(length), Qt::Uninitialized);
+        const int64_t count = shared->positionalRead(data.data(), length, fileOffset);
+        completeBlock(shared, offset, generation, count, data);
+    });
+}
+
+/*!
+ * @brief 将读取结果交给对应的块并唤醒等待的读取，跳转后已作废的结果直接丢弃
+ */
+void ReadAheadStream::completeBlock(const std::shared_ptr<State> &shared, int64_t offset, quint64 generation,
+                                    int64_t count, QByteArray &data) {
+    QMutexLocker locker(&shared->mutex);
+    if (generation != shared->generation) {
+        return;
+    }
+    for (Block &block: shared->blocks) {
+        if (block.offset == offset) {
+            if (count < 0) {
+                block.failed = true;
+            } else {
+                data.resize(static_cast<int>(count));
+                block.data = std::move(data);
+                block.ready = true;
+            }
+            break;
+        }
+    }
+    shared->blockReady.wakeAll();
+}
+
+/*!
+ * @brief 所有预读流共用的读取线程池
+ */
+QThreadPool *ReadAheadStream::readPool() {
+    static QThreadPool *pool = [] {
+        auto *threadPool = new QThreadPool;
+        threadPool->setMaxThreadCount(8);
+        return threadPool;
+    }();
+    return pool;
+}
@@ -1,6 +1,10 @@
 #include "screen_capture.h"
 
-ScreenCapture::ScreenCapture(mpv_handle *mpv, QWidget *parent) : QDialog(parent), mpv(mpv), captureCount(0) {
+#include <cmath>
+#include <memory>
+
+ScreenCapture::ScreenCapture(mpv_handle *mpv, FrameCapture *frameCapture, QWidget *parent)
+        : QDialog(parent), captureCount(0), mpv(mpv), frameCapture(frameCapture) {
     /*!
      * @brief 创建垂直布局
      */
@@ -14,6 +18,11 @@ ScreenCapture::ScreenCapture(mpv_handle *mpv, QWidget *parent) : QDialog(parent)
             &ScreenCapture::on_captureCurrentFrameButton_clicked);
     mainLayout->addWidget(captureCurrentFrameButton);  // 将按钮添加到布局中
 
+    /*!
+     * @brief 当前帧截图的保存选项
+     */
+    mainLayout->addWidget(createCaptureOptionsGroup());
+
     /*!
      * @brief 创建水平布局，放置数字输入框和“截取预览图”按钮
      */
@@ -23,8 +32,18 @@ ScreenCapture::ScreenCapture(mpv_handle *mpv, QWidget *parent) : QDialog(parent)
      * @brief 创建数字输入框
      */
     captureCountSpinBox = new QSpinBox(this);
+    captureCountSpinBox->setRange(1, 999);
+    captureCountSpinBox->setValue(10);
     secondRowLayout->addWidget(captureCountSpinBox);  // 将数字输入框添加到布局中
 
+    /*!
+     * @brief 创建预览图格式选择框
+     */
+    previewFormatComboBox = new QComboBox(this);
+    previewFormatComboBox->addItem("PNG", "png");
+    previewFormatComboBox->addItem("JPEG", "jpg");
+    secondRowLayout->addWidget(previewFormatComboBox);
+
     /*!
      * @brief 创建“截取预览图”按钮
      */
@@ -34,42 +53,135 @@ ScreenCapture::ScreenCapture(mpv_handle *mpv, QWidget *parent) : QDialog(parent)
 
     mainLayout->addLayout(secondRowLayout);  // 将第二行的布局添加到主布局中
 
+    /*!
+     * @brief 创建第三行：缩略图总览的格式、质量与生成按钮，数量与预览图共用
+     */
+    auto *thirdRowLayout = new QHBoxLayout;
+    sheetFormatComboBox = new QComboBox(this);
+    sheetFormatComboBox->addItem("JPEG", "jpg");
+    if (ContactSheet::isFormatSupported("webp")) {
+        sheetFormatComboBox->addItem("WebP", "webp");
+    }
+    thirdRowLayout->addWidget(sheetFormatComboBox);
+
+    sheetQualitySpinBox = new QSpinBox(this);
+    sheetQualitySpinBox->setRange(1, 100);
+    sheetQualitySpinBox->setValue(85);
+    sheetQualitySpinBox->setPrefix(tr("质量 "));
+    thirdRowLayout->addWidget(sheetQualitySpinBox);
+
+    auto *captureContactSheetButton = new QPushButton(tr("生成缩略图总览"), this);
+    connect(captureContactSheetButton, &QPushButton::clicked, this,
+            &ScreenCapture::on_captureContactSheetButton_clicked);
+    thirdRowLayout->addWidget(captureContactSheetButton);
+
+    mainLayout->addLayout(thirdRowLayout);
+
     setLayout(mainLayout);  // 将主布局设置为这个窗口的布局
 }
 
-void ScreenCapture::on_captureCurrentFrameButton_clicked() {
+/*!
+ * @brief 显示截图窗口，instance为空时创建，之后重复使用同一个窗口，避免每次打开都分配新的窗口
+ */
+ScreenCapture *ScreenCapture::present(ScreenCapture *&instance, mpv_handle *mpv, FrameCapture *frameCapture,
+                                      QWidget *parent) {
+    if (!instance) {
+        instance = new ScreenCapture(mpv, frameCapture, parent);
+    }
+    instance->show();
+    instance->raise();
+    instance->activateWindow();
+    return instance;
+}
+
+/*!
+ * @brief 创建当前帧截图的选项，修改后立即保存，快捷键截图使用相同的选项
+ */
+QGroupBox *ScreenCapture::createCaptureOptionsGroup() {
+    const FrameCapture::Options options = FrameCapture::loadOptions();
+    auto *group = new QGroupBox(tr("截图选项"), this);
+    auto *layout = new QFormLayout(group);
+
     /*!
-     * @brief 获取当前的日期和时间
+     * @brief 自动保存目录
      */
-    QDateTime now = QDateTime::currentDateTime();
+    auto *directoryLayout = new QHBoxLayout;
+    captureDirectoryEdit = new QLineEdit(options.directory, group);
+    auto *browseButton = new QPushButton(tr("浏览"), group);
+    connect(browseButton, &QPushButton::clicked, this, [this]() {
+        const QString directory = QFileDialog::getExistingDirectory(this, tr("选择截图保存目录"),
+                                                                    captureDirectoryEdit->text());
+        if (!directory.isEmpty()) {
+            captureDirectoryEdit->setText(directory);
+            saveCaptureOptions();
+        }
+    });
+    directoryLayout->addWidget(captureDirectoryEdit);
+    directoryLayout->addWidget(browseButton);
+    layout->addRow(tr("保存目录"), directoryLayout);
 
     /*!
-     * @brief 格式化文件名
+     * @brief 文件名模板
      */
-    QString tempFileName = QString("%1/AstraPlay_ScreenShot_%2.png")
-            .arg(QStandardPaths::writableLocation(QStandardPaths::TempLocation), now.toString("yyyyMMddHHmm"));
+    captureTemplateEdit = new QLineEdit(options.fileTemplate, group);
+    captureTemplateEdit->setToolTip(tr("%title%：文件名\n%time%：播放位置\n%date%：当前日期时间\n%n%：截图序号"));
+    layout->addRow(tr("文件名模板"), captureTemplateEdit);
 
     /*!
-     * @brief 截图并保存到临时文件中
+     * @brief 格式与质量
      */
-    QStringList args = {"screenshot-to-file", tempFileName.toUtf8().constData(), "video"};
-    mpv::qt::command(mpv, args);
+    captureFormatComboBox = new QComboBox(group);
+    captureFormatComboBox->addItem("PNG", "png");
+    captureFormatComboBox->addItem("JPEG", "jpg");
+    if (ContactSheet::isFormatSupported("webp")) {
+        captureFormatComboBox->addItem("WebP", "webp");
+    }
+    captureFormatComboBox->setCurrentIndex(qMax(0, captureFormatComboBox->findData(QString(options.format))));
+    layout->addRow(tr("格式"), captureFormatComboBox);
+
+    captureQualitySpinBox = new QSpinBox(group);
+    captureQualitySpinBox->setRange(1, 100);
+    captureQualitySpinBox->setValue(options.quality);
+    layout->addRow(tr("质量"), captureQualitySpinBox);
+
+    captureClipboardCheckBox = new QCheckBox(tr("同时复制到剪贴板"), group);
+    captureClipboardCheckBox->setChecked(options.copyToClipboard);
+    layout->addRow(captureClipboardCheckBox);
+
+    connect(captureDirectoryEdit, &QLineEdit::editingFinished, this, &ScreenCapture::saveCaptureOptions);
+    connect(captureTemplateEdit, &QLineEdit::editingFinished, this, &ScreenCapture::saveCaptureOptions);
+    connect(captureFormatComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+            &ScreenCapture::saveCaptureOptions);
+    connect(captureQualitySpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this,
+            &ScreenCapture::saveCaptureOptions);
+    connect(captureClipboardCheckBox, &QCheckBox::toggled, this, &ScreenCapture::saveCaptureOptions);
+    return group;
+}
+
+/*!
+ * @brief 保存截图选项
+ */
+void ScreenCapture::saveCaptureOptions() {
+    FrameCapture::Options options;
+    options.directory = captureDirectoryEdit->text();
+    options.fileTemplate = captureTemplateEdit->text();
+    options.format = captureFormatComboBox->currentData().toByteArray();
+    options.quality = captureQualitySpinBox->value();
+    options.copyToClipboard = captureClipboardCheckBox->isChecked();
+    FrameCapture::saveOptions(options);
+}
+
+/*!
+ * @brief 按当前选项截取当前帧，截图与保存在后台完成
+ */
+void ScreenCapture::on_captureCurrentFrameButton_clicked() {
+    saveCaptureOptions();
+    frameCapture->capture();
 
     /*!
-     * @brief 弹出保存文件对话框
+     * @brief 关闭窗口
      */
-    QString fileName = QFileDialog::getSaveFileName(this, tr("保存截图"), "", tr("图片文件 (*.png *.jpg)"));
-    if (!fileName.isEmpty()) {
-        /*!
-         * @brief 将临时文件移动到用户选择的位置
-         */
-        QFile::rename(tempFileName, fileName);
-
-        /*!
-         * @brief 关闭窗口
-         */
-        this->close();
-    }
+    this->close();
 }
 
 void ScreenCapture::on_capturePreviewButton_clicked() {
@@ -81,8 +193,12 @@ void ScreenCapture::on_capturePreviewButton_clicked() {
     /*!
      * @brief 获取视频的总时长
      */
-    double duration;
-    duration = getProperty("duration").toDouble();
+    double duration = 0.0;
+    MpvProperty::get<MpvProperty::Duration>(mpv, duration);
+    if (duration <= 0) {
+        QMessageBox::critical(this, tr("错误"), tr("没有可以截图的视频"));
+        return;
+    }
 
     /*!
      * @brief 计算截图的时间点
@@ -116,34 +232,129 @@ void ScreenCapture::on_capturePreviewButton_clicked() {
     }
 
     /*!
-     * @brief 进行截图
+     * @brief 计算所有截图的时间点
      */
+    QVector<double> times;
     for (int i = 0; i < captureCount; ++i) {
-        double time = step * (i + 1);
-        mpv::qt::set_property(mpv, "time-pos", time);
+        times.append(step * (i + 1));
+    }
 
-        /*!
-         * @brief 创建文件名
-         */
-        QString fileName = QString("%1/%2_%3.png")
-                .arg(dirName, baseFileName)
-                .arg(i + 1, 3, 10, QChar('0'));  // 使用填充字符'0'和字段宽度3来生成序号
+    /*!
+     * @brief 在后台使用独立的MPV实例并行截图，不改变当前的播放位置
+     */
+    const QString format = previewFormatComboBox->currentData().toString();
+    auto *extractor = new PreviewExtractor(this);
+
+    /*!
+     * @brief 对话框按Esc或关闭按钮关闭时会立即删除，截图线程仍在取消中，完成时先判断是否还存在
+     */
+    QPointer<QProgressDialog> progress = new QProgressDialog(tr("正在截取预览图……"), tr("取消"), 0, captureCount,
+                                                             this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(progress, &QProgressDialog::canceled, extractor, &PreviewExtractor::cancel);
+    connect(extractor, &PreviewExtractor::progressChanged, progress, &QProgressDialog::setValue);
+    connect(extractor, &PreviewExtractor::finished, this, [this, extractor, progress](int succeeded, bool cancelled) {
+        if (progress) {
+            progress->close();
+        }
+        extractor->deleteLater();
+        if (!cancelled && succeeded < captureCount) {
+            QMessageBox::warning(this, tr("警告"), tr("%1张预览图中有%2张截取失败")
+                    .arg(captureCount).arg(captureCount - succeeded));
+        }
 
         /*!
-         * @brief 截图并保存
+         * @brief 关闭窗口
          */
-        QStringList args = {"screenshot-to-file", fileName.toUtf8().constData(), "video"};
-        mpv::qt::command(mpv, args);
+        this->close();
+    });
+
+    extractor->start(MpvProperty::getString(mpv, "path"), times,
+                     [dirName, baseFileName, format](int index, double, const QImage &image) {
+                         /*!
+                          * @brief 创建文件名，使用填充字符'0'和字段宽度3来生成序号
+                          */
+                         QString fileName = QString("%1/%2_%3.%4")
+                                 .arg(dirName, baseFileName)
+                                 .arg(index + 1, 3, 10, QChar('0'))
+                                 .arg(format);
+                         return image.save(fileName, nullptr, format == "jpg" ? 90 : -1);
+                     });
+}
+
+/*!
+ * @brief 生成缩略图总览：帧直接取到内存，在线程池中缩放并绘制到同一张图上，最后一次性写出
+ */
+void ScreenCapture::on_captureContactSheetButton_clicked() {
+    const int count = captureCountSpinBox->value();
+    double duration = 0.0;
+    MpvProperty::get<MpvProperty::Duration>(mpv, duration);
+    if (duration <= 0) {
+        QMessageBox::critical(this, tr("错误"), tr("没有可以截图的视频"));
+        return;
     }
 
     /*!
-     * @brief 关闭窗口
+     * @brief 获取保存位置
      */
-    this->close();
-}
+    const QString format = sheetFormatComboBox->currentData().toString();
+    const QString fileName = QFileDialog::getSaveFileName(
+            this, tr("保存缩略图总览"), QDir::home().filePath(QDir::home().dirName() + "_sheet." + format),
+            format == "webp" ? tr("WebP图片 (*.webp)") : tr("JPEG图片 (*.jpg)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
 
-QVariant ScreenCapture::getProperty(const QString &name) const {
-    return mpv::qt::get_property_variant(mpv, name);
-}
+    /*!
+     * @brief 时间点均匀分布，格子大小按视频显示比例计算，列数接近正方形排布
+     */
+    QVector<double> times;
+    const double step = duration / (count + 1);
+    for (int i = 0; i < count; ++i) {
+        times.append(step * (i + 1));
+    }
+    const int columns = qBound(1, static_cast<int>(std::ceil(std::sqrt(count))), 8);
+    int64_t displayWidth = 0;
+    int64_t displayHeight = 0;
+    MpvProperty::get<MpvProperty::DisplayWidth>(mpv, displayWidth);
+    MpvProperty::get<MpvProperty::DisplayHeight>(mpv, displayHeight);
+    const QSize tileSize = ContactSheet::tileSizeFor(320, static_cast<int>(displayWidth),
+                                                     static_cast<int>(displayHeight));
+    auto sheet = std::make_shared<ContactSheet>(count, columns, tileSize);
 
+    /*!
+     * @brief 与截取预览图相同，进度对话框可能先于截图线程结束被删除
+     */
+    auto *extractor = new PreviewExtractor(this);
+    QPointer<QProgressDialog> progress = new QProgressDialog(tr("正在生成缩略图总览……"), tr("取消"), 0, count, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
 
+    const int quality = sheetQualitySpinBox->value();
+    connect(progress, &QProgressDialog::canceled, extractor, &PreviewExtractor::cancel);
+    connect(extractor, &PreviewExtractor::progressChanged, progress, &QProgressDialog::setValue);
+    connect(extractor, &PreviewExtractor::finished, this,
+            [this, extractor, progress, sheet, fileName, format, quality](int succeeded, bool cancelled) {
+                if (progress) {
+                    progress->close();
+                }
+                extractor->deleteLater();
+                if (cancelled) {
+                    return;
+                }
+                if (succeeded == 0 || !sheet->save(fileName, format.toLatin1(), quality)) {
+                    QMessageBox::critical(this, tr("错误"), tr("无法生成缩略图总览：%1").arg(fileName));
+                    return;
+                }
+                this->close();
+            });
+
+    extractor->start(MpvProperty::getString(mpv, "path"), times, [sheet](int index, double time, const QImage &image) {
+        sheet->addFrame(index, time, image);
+        return true;
+    });
+}
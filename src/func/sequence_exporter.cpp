@@ -0,0 +1,82 @@
+#include "sequence_exporter.h"
+
+SequenceExporter::SequenceExporter(QObject *parent)
+        : QObject(parent), startTime(0.0), endTime(0.0), exported(0), position(0.0) {}
+
+/*!
+ * @brief 开始导出[start, end]之间的所有帧，每个对象只能使用一次
+ */
+void SequenceExporter::start(const QString &filePath, double start, double end, const QString &outputDirectory,
+                             const QString &outputBaseName, const QByteArray &outputFormat) {
+    path = filePath;
+    startTime = start;
+    endTime = end;
+    directory = outputDirectory;
+    baseName = outputBaseName;
+    format = outputFormat;
+
+    timer.start();
+    pipeline.start(1, [this](int) { runDecoder(); }, [this]() {
+        emit finished(exported, framesPerSecond(), pipeline.isCancelled());
+    });
+}
+
+/*!
+ * @brief 取消导出，正在等待的解码立即中断
+ */
+void SequenceExporter::cancel() {
+    pipeline.cancel();
+}
+
+/*!
+ * @brief 解码线程：精确跳转到起点后逐帧前进，直到越过终点或到达文件末尾
+ */
+void SequenceExporter::runDecoder() {
+    FrameGrabber grabber;
+    pipeline.attach(&grabber);
+
+    if (grabber.open(path)) {
+        QImage image = grabber.grab(startTime, true);
+        for (int index = 0; !image.isNull() && !pipeline.isCancelled(); ++index) {
+            const double timePos = grabber.getTimePos();
+            if (index > 0 && timePos > endTime) {
+                break;
+            }
+            position = timePos;
+
+            pipeline.submit([this, index, image]() {
+                if (!pipeline.isCancelled()) {
+                    encodeFrame(index, image);
+                }
+            });
+
+            if (!grabber.step()) {
+                break;
+            }
+            image = grabber.grabCurrent();
+        }
+    }
+
+    pipeline.detach(&grabber);
+}
+
+/*!
+ * @brief 编码并保存一帧，文件名以帧序号结尾
+ */
+void SequenceExporter::encodeFrame(int index, const QImage &image) {
+    const QString fileName = QString("%1/%2_%3.%4")
+            .arg(directory, baseName)
+            .arg(index, 6, 10, QChar('0'))
+            .arg(QString(format));
+    if (image.save(fileName, format.constData(), format == "png" ? -1 : 95)) {
+        emit progressChanged(++exported, position, framesPerSecond());
+    }
+}
+
+/*!
+ * @brief 从开始到现在平均每秒导出的帧数
+ */
+double SequenceExporter::framesPerSecond() const {
+    const qint64 elapsed = timer.elapsed();
+    return elapsed > 0 ? exported * 1000.0 / static_cast<double>(elapsed) : 0.0;
+}
@@ -0,0 +1,335 @@
+#include "session_telemetry.h"
+#include "controller.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTcpSocket>
+#include <QDebug>
+
+#include <algorithm>
+
+/*!
+ * @brief 各属性的名称与格式，顺序与Property一致
+ */
+static const struct {
+    const char *name;
+    mpv_format format;
+} properties[] = {
+        {"paused-for-cache",         MPV_FORMAT_FLAG},
+        {"frame-drop-count",         MPV_FORMAT_INT64},
+        {"decoder-frame-drop-count", MPV_FORMAT_INT64},
+        {"demuxer-cache-duration",   MPV_FORMAT_DOUBLE}
+};
+
+SessionTelemetry::SessionTelemetry(Controller *controller)
+        : QObject(controller), controller(controller), enabled(true), metricsServer(nullptr), staleEndFiles(0),
+          sessionsTotal(0), rebuffersTotal(0), rebufferSecondsTotal(0.0), droppedFramesTotal(0), seeksTotal(0),
+          seekSecondsTotal(0.0), firstFramesTotal(0), firstFrameSecondsTotal(0.0) {
+    /*!
+     * @brief 读取配置，Prometheus端口为0时不监听
+     */
+    QSettings settings("settings.ini", QSettings::IniFormat);
+    settings.beginGroup("telemetry");
+    enabled = settings.value("enabled", true).toBool();
+    directory = settings.value("directory", defaultDirectory()).toString();
+    const quint16 port = static_cast<quint16>(settings.value("prometheusPort", 0).toUInt());
+    settings.endGroup();
+
+    if (!enabled) {
+        return;
+    }
+
+    mpv_handle *mpv = controller->getMpvInstance();
+    for (int i = 0; i < PropertyCount; ++i) {
+        mpv_observe_property(mpv, propertyBase + i, properties[i].name, properties[i].format);
+    }
+    connect(controller, &Controller::observedPropertyChanged, this, &SessionTelemetry::onPropertyChanged);
+    connect(controller, &Controller::playbackRestarted, this, &SessionTelemetry::onPlaybackRestart);
+    connect(controller, &Controller::fileEnded, this, &SessionTelemetry::onFileEnded);
+
+    /*!
+     * @brief 只监听本机回环地址
+     */
+    if (port != 0) {
+        metricsServer = new QTcpServer(this);
+        if (metricsServer->listen(QHostAddress::LocalHost, port)) {
+            connect(metricsServer, &QTcpServer::newConnection, this, &SessionTelemetry::serveMetrics);
+        } else {
+            qWarning() << "无法监听统计端口" << port << metricsServer->errorString();
+        }
+    }
+}
+
+SessionTelemetry::~SessionTelemetry() {
+    endSession("quit");
+}
+
+/*!
+ * @brief 默认的统计目录
+ */
+QString SessionTelemetry::defaultDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/metrics";
+}
+
+/*!
+ * @brief 开始新的会话，上一个会话仍在进行时先结束它
+ */
+void SessionTelemetry::beginSession(const QString &media) {
+    if (!enabled) {
+        return;
+    }
+    if (session.active) {
+        endSession("replaced");
+        ++staleEndFiles;
+    }
+
+    session = Session();
+    session.active = true;
+    session.media = media;
+    session.started = QDateTime::currentDateTime();
+    session.clock.start();
+}
+
+/*!
+ * @brief 结束当前会话并写出统计
+ */
+void SessionTelemetry::endSession(const QString &reason) {
+    if (!session.active) {
+        return;
+    }
+    const QJsonObject summary = summarize(reason);
+    session.active = false;
+    writeSession(summary);
+}
+
+/*!
+ * @brief 发出跳转命令，连续跳转从第一次发出时开始计时，到画面重新开始播放为止
+ */
+void SessionTelemetry::seekStarted() {
+    if (session.active && session.firstFrame >= 0 && session.seekStarted < 0) {
+        session.seekStarted = session.clock.elapsed();
+    }
+}
+
+/*!
+ * @brief 文件播放结束
+ */
+void SessionTelemetry::onFileEnded(int reason) {
+    if (staleEndFiles > 0) {
+        --staleEndFiles;
+        return;
+    }
+
+    switch (reason) {
+        case MPV_END_FILE_REASON_EOF:
+            endSession("eof");
+            break;
+        case MPV_END_FILE_REASON_ERROR:
+            endSession("error");
+            break;
+        default:
+            endSession("stop");
+            break;
+    }
+}
+
+/*!
+ * @brief 文件加载后的第一次为首帧，之后为跳转完成
+ */
+void SessionTelemetry::onPlaybackRestart() {
+    if (!session.active) {
+        return;
+    }
+
+    const qint64 now = session.clock.elapsed();
+    if (session.firstFrame < 0) {
+        session.firstFrame = now;
+        session.cacheChanged = now;
+        return;
+    }
+    if (session.seekStarted >= 0) {
+        session.seekLatencies.append(now - session.seekStarted);
+        session.seekStarted = -1;
+    }
+}
+
+/*!
+ * @brief 记录缓冲状态、丢帧数与缓存时长
+ */
+void SessionTelemetry::onPropertyChanged(const MpvEvent &event) {
+    if (!session.active || event.replyUserdata < propertyBase || event.replyUserdata >= propertyBase + PropertyCount) {
+        return;
+    }
+
+    const bool available = event.format != MPV_FORMAT_NONE;
+    const qint64 now = session.clock.elapsed();
+    switch (static_cast<Property>(event.replyUserdata - propertyBase)) {
+        case PausedForCache:
+            /*!
+             * @brief 首帧之前的缓冲计入首帧时间，不算作中断
+             */
+            if (session.firstFrame < 0) {
+                break;
+            }
+            if (available && event.integer != 0 && session.rebufferStarted < 0) {
+                ++session.rebufferCount;
+                session.rebufferStarted = now;
+            } else if ((!available || event.integer == 0) && session.rebufferStarted >= 0) {
+                session.rebufferTime += now - session.rebufferStarted;
+                session.rebufferStarted = -1;
+            }
+            break;
+        case FrameDropCount:
+            if (available) {
+                session.droppedFrames = event.integer;
+            }
+            break;
+        case DecoderFrameDropCount:
+            if (available) {
+                session.decoderDroppedFrames = event.integer;
+            }
+            break;
+        case CacheDuration:
+            accumulateCache(now);
+            session.cacheDuration = available ? event.number : 0.0;
+            break;
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief 按时间累计缓存时长，用于计算加权平均值
+ */
+void SessionTelemetry::accumulateCache(qint64 now) {
+    if (session.cacheChanged >= 0) {
+        session.cacheIntegral += session.cacheDuration * static_cast<double>(now - session.cacheChanged) / 1000.0;
+        session.cacheChanged = now;
+    }
+}
+
+/*!
+ * @brief 汇总当前会话，同时计入进程内的累计值
+ */
+QJsonObject SessionTelemetry::summarize(const QString &reason) {
+    const qint64 now = session.clock.elapsed();
+    accumulateCache(now);
+    if (session.rebufferStarted >= 0) {
+        session.rebufferTime += now - session.rebufferStarted;
+        session.rebufferStarted = -1;
+    }
+
+    QVector<qint64> seeks = session.seekLatencies;
+    std::sort(seeks.begin(), seeks.end());
+    qint64 seekTotal = 0;
+    for (qint64 latency: seeks) {
+        seekTotal += latency;
+    }
+    const auto seekPercentile = [&seeks](double p) -> qint64 {
+        if (seeks.isEmpty()) {
+            return 0;
+        }
+        return seeks[qMin(static_cast<int>(p * (seeks.size() - 1) + 0.5), seeks.size() - 1)];
+    };
+
+    const qint64 playTime = session.firstFrame >= 0 ? now - session.firstFrame : 0;
+
+    QJsonObject summary;
+    summary["start"] = session.started.toString(Qt::ISODateWithMs);
+    summary["media"] = session.media;
+    summary["end_reason"] = reason;
+    summary["ttff_ms"] = session.firstFrame;
+    summary["play_ms"] = playTime;
+    summary["rebuffer_count"] = session.rebufferCount;
+    summary["rebuffer_ms"] = session.rebufferTime;
+    summary["dropped_frames"] = session.droppedFrames;
+    summary["decoder_dropped_frames"] = session.decoderDroppedFrames;
+    summary["seek_count"] = seeks.size();
+    summary["seek_ms_mean"] = seeks.isEmpty() ? 0.0 : static_cast<double>(seekTotal) / seeks.size();
+    summary["seek_ms_p50"] = seekPercentile(0.50);
+    summary["seek_ms_p95"] = seekPercentile(0.95);
+    summary["seek_ms_max"] = seeks.isEmpty() ? 0 : seeks.last();
+    summary["cache_duration_avg_s"] = playTime > 0 ? session.cacheIntegral * 1000.0 / static_cast<double>(playTime)
+                                                   : 0.0;
+
+    ++sessionsTotal;
+    rebuffersTotal += session.rebufferCount;
+    rebufferSecondsTotal += static_cast<double>(session.rebufferTime) / 1000.0;
+    droppedFramesTotal += session.droppedFrames + session.decoderDroppedFrames;
+    seeksTotal += seeks.size();
+    seekSecondsTotal += static_cast<double>(seekTotal) / 1000.0;
+    if (session.firstFrame >= 0) {
+        ++firstFramesTotal;
+        firstFrameSecondsTotal += static_cast<double>(session.firstFrame) / 1000.0;
+    }
+    return summary;
+}
+
+/*!
+ * @brief 以一行JSON追加到按日期划分的统计文件
+ */
+void SessionTelemetry::writeSession(const QJsonObject &summary) const {
+    if (!QDir().mkpath(directory)) {
+        return;
+    }
+    QFile file(QDir(directory).filePath("sessions-" + QDate::currentDate().toString("yyyyMMdd") + ".jsonl"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return;
+    }
+    file.write(QJsonDocument(summary).toJson(QJsonDocument::Compact));
+    file.write("\n");
+}
+
+/*!
+ * @brief 响应统计端口上的HTTP请求，读到请求头结束后返回文本格式的统计并关闭连接
+ */
+void SessionTelemetry::serveMetrics() {
+    while (QTcpSocket *socket = metricsServer->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            if (!socket->peek(8192).contains("\r\n\r\n")) {
+                return;
+            }
+            const QByteArray body = metricsText();
+            socket->write("HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                          QByteArray::number(body.size()) + "\r\n\r\n" + body);
+            socket->disconnectFromHost();
+        });
+    }
+}
+
+/*!
+ * @brief Prometheus文本格式的累计统计
+ */
+QByteArray SessionTelemetry::metricsText() const {
+    QByteArray text;
+    const auto metric = [&text](const char *name, const char *type, const char *help, double value) {
+        text += QByteArray("# HELP ") + name + " " + help + "\n";
+        text += QByteArray("# TYPE ") + name + " " + type + "\n";
+        text += QByteArray(name) + " " + QByteArray::number(value, 'g', 12) + "\n";
+    };
+
+    metric("astraplay_sessions_total", "counter", "Finished playback sessions.",
+           static_cast<double>(sessionsTotal));
+    metric("astraplay_rebuffers_total", "counter", "Playback stalls waiting for the cache.",
+           static_cast<double>(rebuffersTotal));
+    metric("astraplay_rebuffer_seconds_total", "counter", "Time spent stalled waiting for the cache.",
+           rebufferSecondsTotal);
+    metric("astraplay_dropped_frames_total", "counter", "Frames dropped by the decoder or video output.",
+           static_cast<double>(droppedFramesTotal));
+    metric("astraplay_seek_latency_seconds_sum", "counter", "Sum of seek latencies.", seekSecondsTotal);
+    metric("astraplay_seek_latency_seconds_count", "counter", "Number of completed seeks.",
+           static_cast<double>(seeksTotal));
+    metric("astraplay_first_frame_seconds_sum", "counter", "Sum of times to first frame.", firstFrameSecondsTotal);
+    metric("astraplay_first_frame_seconds_count", "counter", "Number of sessions that reached the first frame.",
+           static_cast<double>(firstFramesTotal));
+    metric("astraplay_cache_duration_seconds", "gauge", "Current demuxer cache duration.",
+           session.active ? session.cacheDuration : 0.0);
+    metric("astraplay_buffering", "gauge", "Whether playback is currently stalled for the cache.",
+           session.active && session.rebufferStarted >= 0 ? 1.0 : 0.0);
+    return text;
+}
@@ -0,0 +1,123 @@
+#include "software_renderer.h"
+
+SoftwareRenderer::SoftwareRenderer(mpv_handle *mpv, QObject *parent)
+        : QObject(parent), mpv(mpv), renderContext(nullptr), buffer(nullptr), size{0, 0}, stride(0),
+          blockForTargetTime(1) {
+    qRegisterMetaType<FrameTiming>();
+}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    release();
+}
+
+/*!
+ * @brief 设置渲染目标缓冲区，缓冲区由调用方持有，需保证在渲染期间有效
+ */
+bool SoftwareRenderer::setTarget(void *targetBuffer, int width, int height, size_t targetStride,
+                                 const char *targetFormat) {
+    buffer = targetBuffer;
+    size[0] = width;
+    size[1] = height;
+    stride = targetStride;
+    format = targetFormat;
+
+    if (renderContext) {
+        return true;
+    }
+
+    /*!
+     * @brief 首次设置目标时创建软件渲染上下文
+     */
+    mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_API_TYPE, const_cast<char *>(MPV_RENDER_API_TYPE_SW)},
+            {MPV_RENDER_PARAM_INVALID,  nullptr}
+    };
+    if (mpv_render_context_create(&renderContext, mpv, params) < 0) {
+        renderContext = nullptr;
+        qWarning() << "MPV软件渲染上下文创建失败";
+        return false;
+    }
+
+    mpv_render_context_set_update_callback(renderContext, &SoftwareRenderer::onMpvRenderUpdate, this);
+    return true;
+}
+
+/*!
+ * @brief 是否等待到帧的目标显示时间再渲染，基准测试时关闭以测量最大吞吐
+ */
+void SoftwareRenderer::setBlockForTargetTime(bool block) {
+    blockForTargetTime = block ? 1 : 0;
+}
+
+/*!
+ * @brief 释放渲染上下文，必须在MPV实例销毁之前调用
+ */
+void SoftwareRenderer::release() {
+    if (renderContext) {
+        mpv_render_context_free(renderContext);
+        renderContext = nullptr;
+    }
+}
+
+/*!
+ * @brief 将当前帧渲染到目标缓冲区
+ */
+bool SoftwareRenderer::renderFrame() {
+    if (!renderContext || !buffer) {
+        return false;
+    }
+
+    mpv_render_frame_info frameInfo{0, 0};
+    mpv_render_param infoParam{MPV_RENDER_PARAM_NEXT_FRAME_INFO, &frameInfo};
+    mpv_render_context_get_info(renderContext, infoParam);
+
+    mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_SW_SIZE,                size},
+            {MPV_RENDER_PARAM_SW_FORMAT,              format.data()},
+            {MPV_RENDER_PARAM_SW_STRIDE,              &stride},
+            {MPV_RENDER_PARAM_SW_POINTER,             buffer},
+            {MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME,  &blockForTargetTime},
+            {MPV_RENDER_PARAM_INVALID,                nullptr}
+    };
+
+    const int64_t renderStart = mpv_get_time_us(mpv);
+    if (mpv_render_context_render(renderContext, params) < 0) {
+        return false;
+    }
+    const int64_t renderEnd = mpv_get_time_us(mpv);
+
+    /*!
+     * @brief 软件渲染没有缓冲区交换，写入完成即视为呈现
+     */
+    FrameTiming timing{};
+    timing.targetTime = frameInfo.target_time;
+    timing.renderTime = renderEnd - renderStart;
+    timing.presentTime = renderEnd;
+    timing.redraw = (frameInfo.flags & MPV_RENDER_FRAME_INFO_REDRAW) != 0;
+    timing.repeat = (frameInfo.flags & MPV_RENDER_FRAME_INFO_REPEAT) != 0;
+
+    mpv_render_context_report_swap(renderContext);
+    emit framePresented(timing);
+    return true;
+}
+
+/*!
+ * @brief MPV渲染更新回调，可能在任意线程中被调用，只负责投递到主线程
+ */
+void SoftwareRenderer::onMpvRenderUpdate(void *ctx) {
+    QMetaObject::invokeMethod(static_cast<SoftwareRenderer *>(ctx), &SoftwareRenderer::handleRenderUpdate,
+                              Qt::QueuedConnection);
+}
+
+/*!
+ * @brief 有新帧时渲染到缓冲区
+ */
+void SoftwareRenderer::handleRenderUpdate() {
+    if (!renderContext) {
+        return;
+    }
+
+    if (mpv_render_context_update(renderContext) & MPV_RENDER_UPDATE_FRAME) {
+        renderFrame();
+    }
+}
@@ -6,7 +6,8 @@ Subtitle::Subtitle(mpv_handle *mpv) : mpv(mpv) {}
  * @brief 加载字幕
  */
 void Subtitle::loadSubtitle(const QString &filename) {
-    const char *cmd[] = {"sub-add", filename.toUtf8().constData(), nullptr};
+    const QByteArray path = filename.toUtf8();
+    const char *cmd[] = {"sub-add", path.constData(), nullptr};
     mpv_command(mpv, cmd);
 }
 
@@ -14,16 +15,16 @@ void Subtitle::loadSubtitle(const QString &filename) {
  * @brief 设置使用的字幕
  */
 void Subtitle::setSubtitleTrack(int track) {
-    mpv::qt::set_property(mpv, "sid", track);
+    MpvProperty::set<MpvProperty::SubtitleTrack>(mpv, track);
 }
 
 /*!
  * @brief 设置字幕同步
  */
 void Subtitle::setSubtitleDelay(double delay) {
-    QVariant QNowDelay = mpv::qt::get_property_variant(mpv, "sub-delay");
-    const double nowDelay = QNowDelay.toDouble();
-    mpv::qt::set_property(mpv, "sub-delay", nowDelay + delay);
+    double nowDelay = 0.0;
+    MpvProperty::get<MpvProperty::SubtitleDelay>(mpv, nowDelay);
+    MpvProperty::set<MpvProperty::SubtitleDelay>(mpv, nowDelay + delay);
 }
 
 /*!
@@ -31,7 +32,7 @@ void Subtitle::setSubtitleDelay(double delay) {
  */
 void Subtitle::setSubtitleFont(const QString &font, int size) {
     mpv::qt::set_property(mpv, "sub-font", font);
-    mpv::qt::set_property(mpv, "sub-font-size", size);
+    MpvProperty::set<MpvProperty::SubtitleFontSize>(mpv, size);
 }
 
 /*!
@@ -41,14 +42,13 @@ QFont Subtitle::getCurrentSubtitleFont() {
     /*!
      * @brief 获取当前的字体字号
      */
-    QVariant QCurrentFontName = mpv::qt::get_property_variant(mpv, "sub-font");
-    QString currentFontName = QCurrentFontName.toString();
-    QVariant QCurrentFontSize = mpv::qt::get_property_variant(mpv, "sub-font-size");
-    int currentFontSize = QCurrentFontSize.toInt();
+    QString currentFontName = MpvProperty::getString(mpv, "sub-font");
+    double currentFontSize = 0.0;
+    MpvProperty::get<MpvProperty::SubtitleFontSize>(mpv, currentFontSize);
 
     QFont currentFont;
     currentFont.setFamily(currentFontName);
-    currentFont.setPointSize(currentFontSize);
+    currentFont.setPointSize(static_cast<int>(currentFontSize));
 
     return currentFont;
 }
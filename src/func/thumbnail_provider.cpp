@@ -0,0 +1,280 @@
+#include "thumbnail_provider.h"
+#include "archive_index.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QMap>
+
+/*!
+ * @brief 缓存容量（KB），约可容纳五六百张160像素宽的缩略图
+ */
+static constexpr int cacheCapacity = 32 * 1024;
+
+/*!
+ * @brief 悬停位置两侧各预取的缩略图数量
+ */
+static constexpr int prefetchRadius = 3;
+
+/*!
+ * @brief 整个进度条上最多区分的缩略图数量，长视频的相邻位置共用同一张缩略图
+ */
+static constexpr int maximumThumbnails = 400;
+
+ThumbnailProvider::ThumbnailProvider(int width, QObject *parent)
+        : QObject(parent), width(width), worker(nullptr), cache(cacheCapacity), generatingSheet(false), fileGeneration(0),
+          maximumSecond(0), step(1), stopping(false), activeGrabber(nullptr) {
+    worker = QThread::create([this]() { run(); });
+    worker->start(QThread::LowPriority);
+}
+
+ThumbnailProvider::~ThumbnailProvider() {
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        pending.wakeAll();
+        if (activeGrabber) {
+            activeGrabber->abort();
+        }
+    }
+    worker->wait();
+    delete worker;
+}
+
+/*!
+ * @brief 只为本地文件与归档成员生成缩略图，网络地址再开一路连接的代价过高
+ */
+bool ThumbnailProvider::isSupported(const QString &path) {
+    if (path.startsWith(QString(ArchiveIndex::protocol) + "://")) {
+        return true;
+    }
+    return QFileInfo(path).isFile();
+}
+
+/*!
+ * @brief 根据时长确定缩略图的时间间隔，悬停请求与拼图使用相同的间隔
+ */
+int ThumbnailProvider::intervalFor(double duration) {
+    return qMax(1, static_cast<int>(duration) / maximumThumbnails);
+}
+
+/*!
+ * @brief 切换到新的文件，丢弃尚未处理的请求，后台线程随后读取或开始生成该文件的拼图
+ */
+void ThumbnailProvider::setFile(const QString &newPath) {
+    QMutexLocker locker(&mutex);
+    path = isSupported(newPath) ? newPath : QString();
+    maximumSecond = 0;
+    step = 1;
+    queue.clear();
+    sheet.reset();
+    generatingSheet = !path.isEmpty();
+    ++fileGeneration;
+    pending.wakeOne();
+}
+
+/*!
+ * @brief 更新时长
+ */
+void ThumbnailProvider::setDuration(double duration) {
+    QMutexLocker locker(&mutex);
+    maximumSecond = qMax(0, static_cast<int>(duration));
+    step = intervalFor(duration);
+}
+
+/*!
+ * @brief 是否有可以生成缩略图的文件
+ */
+bool ThumbnailProvider::hasFile() const {
+    QMutexLocker locker(&mutex);
+    return !path.isEmpty() && maximumSecond > 0;
+}
+
+/*!
+ * @brief 将时间对齐到缩略图间隔，返回缓存使用的秒数
+ */
+int ThumbnailProvider::keyFor(int second) const {
+    QMutexLocker locker(&mutex);
+    return qBound(0, second, maximumSecond) / step * step;
+}
+
+/*!
+ * @brief 从缓存或拼图中查找缩略图
+ */
+bool ThumbnailProvider::lookup(int second, QImage *image) {
+    QMutexLocker locker(&mutex);
+    if (const QImage *cached = cache.object({path, second})) {
+        *image = *cached;
+        return true;
+    }
+    if (sheet) {
+        *image = sheet->tile(second);
+        return !image->isNull();
+    }
+    return false;
+}
+
+/*!
+ * @brief 请求second处的缩略图并预取两侧，之前尚未处理的请求作废
+ */
+void ThumbnailProvider::request(int second) {
+    QMutexLocker locker(&mutex);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    /*!
+     * @brief 已有拼图时所有缩略图都可以直接读取，无需再取帧
+     */
+    queue.clear();
+    if (sheet) {
+        return;
+    }
+    auto enqueue = [this](int key) {
+        if (key >= 0 && key <= maximumSecond && !cache.contains({path, key})) {
+            queue.push_back(key);
+        }
+    };
+    enqueue(second);
+    for (int i = 1; i <= prefetchRadius; ++i) {
+        enqueue(second + i * step);
+        enqueue(second - i * step);
+    }
+
+    if (!queue.empty()) {
+        pending.wakeOne();
+    }
+}
+
+/*!
+ * @brief 后台线程：优先处理悬停请求，空闲时逐张补齐拼图，取帧用的MPV实例在该线程中创建与销毁
+ */
+void ThumbnailProvider::run() {
+    FrameGrabber grabber(width, true);
+    {
+        QMutexLocker locker(&mutex);
+        activeGrabber = &grabber;
+    }
+
+    /*!
+     * @brief 以下状态只在后台线程中使用，对应currentTarget所指的文件
+     */
+    QString currentTarget;
+    quint64 currentGeneration = 0;
+    bool grabberReady = false;
+    int interval = 1;
+    int lastSecond = 0;
+    int nextTile = 0;
+    QMap<int, QImage> tiles;
+
+    forever {
+        QString target;
+        quint64 generation;
+        int second = -1;
+        {
+            QMutexLocker locker(&mutex);
+            while (!stopping && queue.empty() && !generatingSheet) {
+                pending.wait(&mutex);
+            }
+            if (stopping) {
+                break;
+            }
+            target = path;
+            generation = fileGeneration;
+            if (!queue.empty()) {
+                second = queue.front();
+                queue.pop_front();
+            }
+            if (target.isEmpty()) {
+                generatingSheet = false;
+                continue;
+            }
+        }
+
+        /*!
+         * @brief 切换文件（包括重新打开同一文件）后先尝试读取已保存的拼图，读到则不必加载文件
+         */
+        if (target != currentTarget || generation != currentGeneration) {
+            currentTarget = target;
+            currentGeneration = generation;
+            grabberReady = false;
+            nextTile = 0;
+            tiles.clear();
+
+            const QSharedPointer<const ThumbnailSheet> saved = ThumbnailSheet::load(target);
+            if (saved) {
+                QMutexLocker locker(&mutex);
+                if (path == target) {
+                    sheet = saved;
+                    generatingSheet = false;
+                    queue.clear();
+                }
+                continue;
+            }
+        }
+
+        if (!grabberReady) {
+            if (!grabber.open(target)) {
+                QMutexLocker locker(&mutex);
+                if (path == target) {
+                    queue.clear();
+                    generatingSheet = false;
+                }
+                continue;
+            }
+            grabberReady = true;
+            interval = intervalFor(grabber.getDuration());
+            lastSecond = static_cast<int>(grabber.getDuration());
+        }
+
+        /*!
+         * @brief 没有悬停请求时生成拼图的下一张，跳过悬停时已经取到的
+         */
+        const bool idle = second < 0;
+        if (idle) {
+            while (tiles.contains(nextTile)) {
+                nextTile += interval;
+            }
+            second = nextTile;
+            nextTile += interval;
+        }
+
+        if (second <= lastSecond) {
+            const QImage image = grabber.grab(second);
+            if (!image.isNull()) {
+                if (second % interval == 0) {
+                    tiles.insert(second, image);
+                }
+                {
+                    QMutexLocker locker(&mutex);
+                    if (target != path) {
+                        continue;
+                    }
+                    cache.insert({target, second}, new QImage(image),
+                                 qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+                }
+                emit thumbnailReady(second, image);
+            }
+        }
+
+        /*!
+         * @brief 整个文件的缩略图都已取到时保存拼图
+         */
+        if (idle && nextTile > lastSecond) {
+            const QSharedPointer<const ThumbnailSheet> saved = ThumbnailSheet::save(target, interval, tiles);
+            tiles.clear();
+            {
+                QMutexLocker locker(&mutex);
+                if (path == target) {
+                    sheet = saved;
+                    generatingSheet = false;
+                }
+            }
+            if (saved) {
+                emit sheetSaved(target);
+            }
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    activeGrabber = nullptr;
+}
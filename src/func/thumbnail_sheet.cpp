@@ -0,0 +1,205 @@
+#include "thumbnail_sheet.h"
+#include "archive_index.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QPainter>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <cmath>
+
+/*!
+ * @brief 索引文件头，格式变化时递增版本号，旧索引会被视为不存在
+ */
+static constexpr quint32 indexMagic = 0x41535453;  // "ASTS"
+static constexpr quint16 indexVersion = 1;
+
+/*!
+ * @brief 拼图的JPEG压缩质量
+ */
+static constexpr int spriteQuality = 80;
+
+/*!
+ * @brief 缩略图缓存目录
+ */
+QString ThumbnailSheet::cacheDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+}
+
+/*!
+ * @brief 由路径、大小与修改时间计算缓存名，文件被替换或修改后自动失效，无法读取文件信息时返回空字符串
+ */
+QString ThumbnailSheet::cacheKey(const QString &path) {
+    QString filePath = path;
+    QString member;
+    if (path.startsWith(QString(ArchiveIndex::protocol) + "://") && !ArchiveIndex::parseUri(path, &filePath, &member)) {
+        return {};
+    }
+
+    const QFileInfo info(filePath);
+    if (!info.isFile()) {
+        return {};
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(member.toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/*!
+ * @brief 读取已生成的拼图与索引，不存在或已失效时返回空指针
+ */
+QSharedPointer<const ThumbnailSheet> ThumbnailSheet::load(const QString &path) {
+    const QString key = cacheKey(path);
+    if (key.isEmpty()) {
+        return {};
+    }
+
+    auto sheet = QSharedPointer<ThumbnailSheet>::create();
+    const QString base = cacheDirectory() + "/" + key;
+    if (!readIndex(base + ".idx", &sheet->interval, &sheet->rects)) {
+        return {};
+    }
+    if (!sheet->sprite.load(base + ".jpg", "JPG")) {
+        return {};
+    }
+    return sheet;
+}
+
+/*!
+ * @brief 只解码拼图中的封面缩略图（约十分之一处），供历史记录菜单使用
+ */
+QImage ThumbnailSheet::loadCover(const QString &path) {
+    const QString key = cacheKey(path);
+    if (key.isEmpty()) {
+        return {};
+    }
+
+    int interval = 1;
+    QMap<int, QRect> rects;
+    const QString base = cacheDirectory() + "/" + key;
+    if (!readIndex(base + ".idx", &interval, &rects) || rects.isEmpty()) {
+        return {};
+    }
+
+    QImageReader reader(base + ".jpg", "JPG");
+    reader.setClipRect((rects.constBegin() + rects.size() / 10).value());
+    return reader.read();
+}
+
+/*!
+ * @brief 将按时间排列的缩略图拼接保存，返回保存后的拼图
+ */
+QSharedPointer<const ThumbnailSheet> ThumbnailSheet::save(const QString &path, int interval,
+                                                          const QMap<int, QImage> &tiles) {
+    const QString key = cacheKey(path);
+    if (key.isEmpty() || tiles.isEmpty() || !QDir().mkpath(cacheDirectory())) {
+        return {};
+    }
+
+    /*!
+     * @brief 以第一张缩略图的尺寸为准，拼成接近正方形的网格
+     */
+    const QSize tileSize = tiles.first().size();
+    const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tiles.size()))));
+    const int rows = (tiles.size() + columns - 1) / columns;
+
+    auto sheet = QSharedPointer<ThumbnailSheet>::create();
+    sheet->interval = interval;
+    sheet->sprite = QImage(columns * tileSize.width(), rows * tileSize.height(), QImage::Format_RGB32);
+    sheet->sprite.fill(Qt::black);
+
+    QPainter painter(&sheet->sprite);
+    int index = 0;
+    for (auto it = tiles.constBegin(); it != tiles.constEnd(); ++it, ++index) {
+        const QRect rect(index % columns * tileSize.width(), index / columns * tileSize.height(),
+                         tileSize.width(), tileSize.height());
+        painter.drawImage(rect, it.value());
+        sheet->rects.insert(it.key(), rect);
+    }
+    painter.end();
+
+    /*!
+     * @brief 先写拼图再写索引，读取时以索引存在为准，避免读到不完整的拼图
+     */
+    const QString base = cacheDirectory() + "/" + key;
+    QSaveFile spriteFile(base + ".jpg");
+    if (!spriteFile.open(QIODevice::WriteOnly)) {
+        return {};
+    }
+    QImageWriter writer(&spriteFile, "JPG");
+    writer.setQuality(spriteQuality);
+    writer.setOptimizedWrite(true);
+    if (!writer.write(sheet->sprite) || !spriteFile.commit()) {
+        return {};
+    }
+
+    QSaveFile indexFile(base + ".idx");
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        return {};
+    }
+    QDataStream stream(&indexFile);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << indexMagic << indexVersion << static_cast<qint32>(interval) << static_cast<qint32>(sheet->rects.size());
+    for (auto it = sheet->rects.constBegin(); it != sheet->rects.constEnd(); ++it) {
+        stream << static_cast<qint32>(it.key()) << it.value();
+    }
+    if (stream.status() != QDataStream::Ok || !indexFile.commit()) {
+        return {};
+    }
+    return sheet;
+}
+
+/*!
+ * @brief 返回second之前最近的一张缩略图
+ */
+QImage ThumbnailSheet::tile(int second) const {
+    auto it = rects.upperBound(second);
+    if (it == rects.constBegin()) {
+        return {};
+    }
+    --it;
+    if (second - it.key() >= interval) {
+        return {};
+    }
+    return sprite.copy(it.value());
+}
+
+/*!
+ * @brief 读取二进制索引
+ */
+bool ThumbnailSheet::readIndex(const QString &indexPath, int *interval, QMap<int, QRect> *rects) {
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 storedInterval = 0, count = 0;
+    stream >> magic >> version >> storedInterval >> count;
+    if (magic != indexMagic || version != indexVersion || storedInterval <= 0 || count < 0) {
+        return false;
+    }
+
+    for (qint32 i = 0; i < count; ++i) {
+        qint32 second = 0;
+        QRect rect;
+        stream >> second >> rect;
+        rects->insert(second, rect);
+    }
+    *interval = storedInterval;
+    return stream.status() == QDataStream::Ok;
+}
@@ -0,0 +1,218 @@
+#include "trace.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QCoreApplication>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> enabled(false);
+
+namespace {
+
+/*!
+ * @brief 单条记录，定长以便预先分配
+ */
+struct Event {
+    const char *name;
+
+    const char *category;
+
+    char detail[32];
+
+    int64_t timestamp;
+
+    int64_t duration;
+
+    char phase;
+};
+
+/*!
+ * @brief 每个线程的环形缓冲区，只由所属线程写入，写满后覆盖最早的记录。count为已发布的记录总数，
+ * 以release语义发布、写出时以acquire语义读取；claimed在写入槽位之前更新，写出时据此丢弃复制过程中被覆盖的槽位
+ */
+struct ThreadBuffer {
+    static constexpr size_t capacity = 32768;
+
+    uint64_t threadId = 0;
+
+    const char *threadName = nullptr;
+
+    std::unique_ptr<Event[]> events{new Event[capacity]};
+
+    std::atomic<uint64_t> count{0};
+
+    std::atomic<uint64_t> claimed{0};
+};
+
+const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+/*!
+ * @brief 所有线程的缓冲区，只在线程第一次记录时加锁登记，线程退出后缓冲区仍保留到写出
+ */
+QMutex registryMutex;
+
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+std::atomic<uint64_t> nextThreadId(1);
+
+ThreadBuffer *currentBuffer() {
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (!buffer) {
+        auto created = std::make_unique<ThreadBuffer>();
+        created->threadId = nextThreadId++;
+        buffer = created.get();
+        QMutexLocker locker(&registryMutex);
+        registry.push_back(std::move(created));
+    }
+    return buffer;
+}
+
+void record(char phase, const char *name, const char *category, int64_t timestamp, int64_t duration,
+            const char *detail) {
+    ThreadBuffer *buffer = currentBuffer();
+    const uint64_t index = buffer->count.load(std::memory_order_relaxed);
+    buffer->claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Event &event = buffer->events[index % ThreadBuffer::capacity];
+    event.name = name;
+    event.category = category;
+    event.timestamp = timestamp;
+    event.duration = duration;
+    event.phase = phase;
+    if (detail) {
+        std::strncpy(event.detail, detail, sizeof(event.detail) - 1);
+        event.detail[sizeof(event.detail) - 1] = '\0';
+    } else {
+        event.detail[0] = '\0';
+    }
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+}
+
+/*!
+ * @brief 开始记录
+ */
+void enable() {
+    enabled = true;
+}
+
+/*!
+ * @brief 自进程启动以来的微秒数
+ */
+int64_t now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void complete(const char *name, const char *category, int64_t start, int64_t duration, const char *detail) {
+    if (isEnabled()) {
+        record('X', name, category, start, duration, detail);
+    }
+}
+
+void instant(const char *name, const char *category, const char *detail) {
+    if (isEnabled()) {
+        record('i', name, category, now(), 0, detail);
+    }
+}
+
+void setThreadName(const char *name) {
+    if (isEnabled()) {
+        currentBuffer()->threadName = name;
+    }
+}
+
+/*!
+ * @brief 写出为Chrome trace_event JSON，可在记录进行中调用，只写出调用时已发布的记录
+ */
+bool dump(const QString &fileName) {
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    QMutexLocker locker(&registryMutex);
+    for (const auto &buffer: registry) {
+        const auto tid = static_cast<qint64>(buffer->threadId);
+        if (buffer->threadName) {
+            traceEvents.append(QJsonObject{
+                    {"ph",   "M"},
+                    {"name", "thread_name"},
+                    {"pid",  pid},
+                    {"tid",  tid},
+                    {"args", QJsonObject{{"name", buffer->threadName}}}
+            });
+        }
+
+        /*!
+         * @brief 先复制仍在缓冲区中的记录，再丢弃复制期间已被所属线程覆盖的部分
+         */
+        const uint64_t count = buffer->count.load(std::memory_order_acquire);
+        uint64_t first = count > ThreadBuffer::capacity ? count - ThreadBuffer::capacity : 0;
+        std::vector<Event> events(count - first);
+        for (uint64_t i = first; i < count; ++i) {
+            events[i - first] = buffer->events[i % ThreadBuffer::capacity];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t claimed = buffer->claimed.load(std::memory_order_relaxed);
+        const uint64_t overwritten = claimed > ThreadBuffer::capacity ? claimed - ThreadBuffer::capacity : 0;
+        const size_t skipped = static_cast<size_t>(qMax(first, overwritten) - first);
+        first = qMax(first, overwritten);
+
+        for (size_t i = skipped; i < events.size(); ++i) {
+            const Event &event = events[i];
+            QJsonObject object{
+                    {"ph",   QString(QLatin1Char(event.phase))},
+                    {"name", event.name},
+                    {"cat",  event.category},
+                    {"pid",  pid},
+                    {"tid",  tid},
+                    {"ts",   static_cast<qint64>(event.timestamp)}
+            };
+            if (event.phase == 'X') {
+                object["dur"] = static_cast<qint64>(event.duration);
+            } else {
+                object["s"] = "t";
+            }
+            if (event.detail[0] != '\0') {
+                object["args"] = QJsonObject{{"detail", QString::fromUtf8(event.detail)}};
+            }
+            traceEvents.append(object);
+        }
+
+        if (first > 0) {
+            traceEvents.append(QJsonObject{
+                    {"ph",   "i"},
+                    {"name", "trace buffer wrapped"},
+                    {"cat",  "trace"},
+                    {"pid",  pid},
+                    {"tid",  tid},
+                    {"ts",   skipped < events.size() ? static_cast<qint64>(events[skipped].timestamp) : now()},
+                    {"s",    "t"},
+                    {"args", QJsonObject{{"overwritten", static_cast<qint64>(first)}}}
+            });
+        }
+    }
+    locker.unlock();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    const QJsonObject root{
+            {"traceEvents",     traceEvents},
+            {"displayTimeUnit", "ms"}
+    };
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+}
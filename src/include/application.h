@@ -23,6 +23,14 @@
 #include <QFontDatabase>
 #include <QShortcut>
 #include <QDir>
+#include <QInputDialog>
+#include <QVBoxLayout>
+#include <QMouseEvent>
+#include <QStyle>
+#include <QProgressDialog>
+#include <QPointer>
+#include <QStatusBar>
+#include <QDateTime>
 
 #include "../../resources/ui_application.h"
 #include "controller.h"
@@ -31,6 +39,12 @@
 #include "output_window.h"
 #include "media_info.h"
 #include "subtitle.h"
+#include "archive_index.h"
+#include "thumbnail_provider.h"
+#include "frame_capture.h"
+#include "sequence_exporter.h"
+#include "log_viewer.h"
+#include "performance_hud.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -119,7 +133,9 @@ public:
      * @brief 使用快捷键设置音量后，对应更新滑块位置
      */
     void updateVolumeSlider(const int newVolume) {
-        volumeWidget->slider->setValue(newVolume);
+        if (volumeWidget && volumeWidget->slider->value() != newVolume) {
+            volumeWidget->slider->setValue(newVolume);
+        }
     }
 
 protected:
@@ -189,8 +205,20 @@ private:
 
     void on_actionOpenFile_triggered();
 
+    QString selectArchiveMember(const QString &archivePath);
+
+    void initThumbnailPreview();
+
+    void showThumbnail(int x);
+
+    void hideThumbnail();
+
     void on_actionExitProgram_triggered();
 
+    void on_actionExportDiagnostics_triggered();
+
+    void on_actionShowLog_triggered();
+
     void on_actionTogglePlayPause_triggered();
 
     void on_slider_Released();
@@ -251,6 +279,12 @@ private:
 
     void on_actionNextFrame_triggered();
 
+    void on_actionMarkPointA_triggered();
+
+    void on_actionMarkPointB_triggered();
+
+    void on_actionExportSequence_triggered();
+
     void on_subtitleControl_clicked();
 
     void on_speedHalf_activated();
@@ -284,9 +318,31 @@ private:
 
     bool isFullScreen;
 
-    Qt::WindowFlags originalFlags;
+    Qt::WindowStates originalState;
 
     QString filename;
+
+    ThumbnailProvider *thumbnailProvider = nullptr;
+
+    QWidget *thumbnailPopup = nullptr;
+
+    QLabel *thumbnailImage = nullptr;
+
+    QLabel *thumbnailTime = nullptr;
+
+    int hoveredSecond = -1;
+
+    FrameCapture *frameCapture = nullptr;
+
+    double pointA = -1.0;
+
+    double pointB = -1.0;
+
+    LogViewer *logViewer = nullptr;
+
+    ScreenCapture *screenCapture = nullptr;
+
+    PerformanceHud *performanceHud = nullptr;
 };
 
 #endif // APPLICATION_H
@@ -0,0 +1,62 @@
+#ifndef ARCHIVE_INDEX_H
+#define ARCHIVE_INDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QtEndian>
+
+/*!
+ * @brief 归档文件中的一个成员
+ */
+struct ArchiveEntry {
+    QString name;
+    int64_t offset;     // 成员数据在归档文件中的起始位置
+    int64_t size;
+    bool stored;        // 未压缩（TAR成员或ZIP的stored方式），只有这类成员可以直接播放
+};
+
+/*!
+ * @brief TAR与ZIP归档的成员索引
+ *
+ * 索引只读取TAR头或ZIP中央目录，每个归档只建立一次并按路径、大小与修改时间缓存，
+ * 成员数据之后直接从归档文件中按偏移读取，无需解压到临时目录。
+ */
+class ArchiveIndex {
+public:
+    static constexpr const char *protocol = "archive";
+
+    static QSharedPointer<const ArchiveIndex> load(const QString &path);
+
+    static bool isArchive(const QString &path);
+
+    static QString toUri(const QString &archivePath, const QString &member);
+
+    static bool parseUri(const QString &uri, QString *archivePath, QString *member);
+
+    [[nodiscard]] const ArchiveEntry *find(const QString &member) const;
+
+    [[nodiscard]] QStringList playableMembers() const;
+
+private:
+    bool parseTar(QFile &file);
+
+    bool parseZip(QFile &file);
+
+private:
+    QVector<ArchiveEntry> entries;
+
+    QHash<QString, int> entryIndex;
+
+    int64_t archiveSize = 0;
+
+    QDateTime lastModified;
+};
+
+#endif //ARCHIVE_INDEX_H
@@ -0,0 +1,42 @@
+#ifndef CONTACT_SHEET_H
+#define CONTACT_SHEET_H
+
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <QByteArray>
+#include <QSize>
+#include <QRect>
+
+/*!
+ * @brief 缩略图总览（contact sheet）
+ *
+ * 所有帧缩放后按时间顺序排成网格绘制在同一张图像上，每格标注时间码，最后一次性写出。
+ * addFrame()可在多个线程中同时调用，缩放在调用线程中完成，只有绘制到画布时加锁。
+ */
+class ContactSheet {
+public:
+    ContactSheet(int count, int columns, const QSize &tileSize);
+
+    void addFrame(int index, double time, const QImage &frame);
+
+    bool save(const QString &fileName, const QByteArray &format, int quality) const;
+
+    static QSize tileSizeFor(int tileWidth, int videoWidth, int videoHeight);
+
+    static bool isFormatSupported(const QByteArray &format);
+
+private:
+    QRect tileRect(int index) const;
+
+private:
+    const int columns;
+
+    const QSize tileSize;
+
+    mutable QMutex mutex;
+
+    QImage canvas;
+};
+
+#endif //CONTACT_SHEET_H
@@ -4,12 +4,30 @@
 #include <QObject>
 #include <QWidget>
 #include <QVariant>
-#include <QTimer>
 #include <QTime>
 #include <QMessageBox>
+#include <QHash>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QThread>
+
+#include <functional>
+#include <memory>
+#include <atomic>
 
 #include "mpv/client.h"
 #include "mpv/qthelper.hpp"
+#include "player_widget.h"
+#include "software_renderer.h"
+#include "local_stream.h"
+#include "frame_index.h"
+#include "input_coalescer.h"
+#include "mpv_property.h"
+#include "diagnostics.h"
+#include "mpv_event_thread.h"
+#include "mpv_log.h"
+#include "session_telemetry.h"
+#include "trace.h"
 
 class Application;
 
@@ -17,13 +35,39 @@ class Controller : public QObject {
 Q_OBJECT
 
 public:
+    /*!
+     * @brief 异步命令完成后的回调，error为MPV错误码，result为命令返回值
+     */
+    using ReplyCallback = std::function<void(int error, const QVariant &result)>;
+
+    /*!
+     * @brief app为空时以无界面模式运行，不操作任何界面控件，视频通过软件渲染输出到内存
+     */
     explicit Controller(Application *app, QObject *parent = nullptr);
 
     ~Controller() override;
 
     [[nodiscard]] mpv_handle *getMpvInstance() const;
 
-    void setPlayerWidget(QWidget *widget);
+    void setPlayerWidget(PlayerWidget *widget);
+
+    SoftwareRenderer *setSoftwareRenderTarget(void *buffer, int width, int height, size_t stride);
+
+    [[nodiscard]] bool isHeadless() const;
+
+    [[nodiscard]] Diagnostics *getDiagnostics() const;
+
+    void setLogLevel(const QString &level);
+
+    [[nodiscard]] const QString &getLogLevel() const;
+
+    [[nodiscard]] const MpvLog &getMpvLog() const;
+
+    [[nodiscard]] const QString &getCurrentFile() const;
+
+    [[nodiscard]] double getTimePos() const;
+
+    [[nodiscard]] double getDuration() const;
 
     void openFile(const QString &filename);
 
@@ -43,9 +87,9 @@ public:
 
     void setSpeedMultiple(double multiple);
 
-    void updateSliderPosition();
+    void updateSliderPosition(double time);
 
-    void updateSliderDuration();
+    void updateSliderDuration(double newDuration);
 
     void initializeSliderDuration();
 
@@ -53,6 +97,8 @@ public:
 
     void sliderDragStopped();
 
+    void scrubTo(int seconds);
+
     void handleUrl(const QString &url);
 
     void zoomIn();
@@ -75,8 +121,6 @@ public:
 
     void resetAudioSync();
 
-    void getFrameRate();
-
     void goToPreviousFrame();
 
     void goToNextFrame();
@@ -85,13 +129,135 @@ public:
 
     void setProperty(const QString &name, const QVariant &value);
 
+    void commandAsync(const QStringList &args, const ReplyCallback &callback = nullptr);
+
+    void setPropertyAsync(const QString &name, const QVariant &value, const ReplyCallback &callback = nullptr);
+
     [[nodiscard]] QVariant getProperty(const QString &name) const;
 
+    template<typename Prop>
+    [[nodiscard]] typename Prop::Type get() const;
+
+    template<typename Prop>
+    void set(typename Prop::Type value);
+
+    template<typename Prop>
+    void setAsync(typename Prop::Type value, const ReplyCallback &callback = nullptr);
+
+    [[nodiscard]] const QVariantList &getTrackList() const;
+
+signals:
+
+    /*!
+     * @brief 媒体时长发生变化
+     */
+    void durationChanged(double duration);
+
+    /*!
+     * @brief 播放/暂停状态发生变化
+     */
+    void pauseChanged(bool isPaused);
+
+    /*!
+     * @brief 静音状态发生变化
+     */
+    void muteChanged(bool isMute);
+
+    /*!
+     * @brief 音量发生变化
+     */
+    void volumeChanged(int volume);
+
+    /*!
+     * @brief 播放速度发生变化
+     */
+    void speedChanged(double speed);
+
+    /*!
+     * @brief 轨道列表发生变化
+     */
+    void trackListChanged();
+
+    /*!
+     * @brief 由其他模块通过mpv_observe_property监听的属性发生变化，event.node只在信号处理期间有效
+     */
+    void observedPropertyChanged(const MpvEvent &event);
+
+    /*!
+     * @brief 文件加载或跳转后画面重新开始播放
+     */
+    void playbackRestarted();
+
+    /*!
+     * @brief 文件加载完成
+     */
+    void fileLoaded();
+
+    /*!
+     * @brief 文件播放结束或被卸载，reason为mpv_end_file_reason
+     */
+    void fileEnded(int reason);
+
 private:
+    /*!
+     * @brief 通过mpv_observe_property监听的属性，数值作为reply_userdata区分事件来源
+     */
+    enum ObservedProperty : uint64_t {
+        TimePosProperty = 1,
+        DurationProperty,
+        PauseProperty,
+        MuteProperty,
+        VolumeProperty,
+        SpeedProperty,
+        TrackListProperty
+    };
+
+    void handleMpvEvents();
+
+    void handlePropertyChange(const MpvEvent &event);
+
+    void handleReply(const MpvEvent &event);
+
+    void reportError(const QString &message, int error) const;
+
+    void updateTimeLabel();
+
+    void addPropertyChannel(const QString &name);
+
+    void finishScrubSeek();
+
+    void seekToFrame(int frame);
+
+    void finishFrameStep();
+
+    void cancelFrameStep();
+
+    void resetFrameIndex();
+
+    void buildFrameIndex();
+
+    static QString formatTime(double seconds);
+
     mpv_handle *mpv;
 
     Application *application;
 
+    QPointer<PlayerWidget> playerWidget;
+
+    SoftwareRenderer *softwareRenderer;
+
+    Diagnostics *diagnostics;
+
+    MpvLog mpvLog;
+
+    QString logLevel;
+
+    std::unique_ptr<MpvEventThread> eventThread;
+
+    std::atomic<bool> eventsScheduled;
+
+    SessionTelemetry *telemetry;
+
     bool sliderBeingDragged;
 
     bool sliderInitialized;
@@ -104,9 +270,92 @@ private:
 
     double panY;
 
-    double frameRate;
+    double timePos;
+
+    int displayedSecond;
 
-    QTime totalTime;
+    bool isPaused;
+
+    bool isMute;
+
+    double volume;
+
+    double speed;
+
+    QVariantList trackList;
+
+    QString totalTimeString;
+
+    QString currentFile;
+
+    bool scrubSeekInFlight;
+
+    double pendingScrubTarget;
+
+    InputCoalescer inputCoalescer;
+
+    QSharedPointer<const FrameIndex> frameIndex;
+
+    std::shared_ptr<std::atomic<bool>> frameIndexAborted;
+
+    int frameIndexGeneration;
+
+    /*!
+     * @brief 按索引后退时期望停留的帧与正在跳转的帧，没有时为-1
+     */
+    int stepTargetFrame;
+
+    int stepSeekFrame;
+
+    uint64_t nextReplyId;
+
+    QHash<uint64_t, ReplyCallback> pendingReplies;
 };
 
+/*!
+ * @brief 以原生格式读取属性表中的属性，属性不可用时返回默认值，不弹出错误提示
+ */
+template<typename Prop>
+typename Prop::Type Controller::get() const {
+    TRACE_SCOPE("mpv_get_property", "mpv", Prop::name);
+
+    typename Prop::Type value{};
+    MpvProperty::get<Prop>(mpv, value);
+    return value;
+}
+
+/*!
+ * @brief 以原生格式同步设置属性表中的属性
+ */
+template<typename Prop>
+void Controller::set(typename Prop::Type value) {
+    TRACE_SCOPE("mpv_set_property", "mpv", Prop::name);
+
+    const int error = MpvProperty::set<Prop>(mpv, value);
+    if (error < 0) {
+        reportError("MPV设置参数错误：", error);
+    }
+}
+
+/*!
+ * @brief 以原生格式异步设置属性表中的属性，完成后在主线程中执行回调
+ */
+template<typename Prop>
+void Controller::setAsync(typename Prop::Type value, const ReplyCallback &callback) {
+    TRACE_SCOPE("mpv_set_property_async", "mpv", Prop::name);
+
+    const uint64_t replyId = nextReplyId++;
+    pendingReplies.insert(replyId, callback);
+
+    const int error = MpvProperty::setAsync<Prop>(mpv, replyId, value);
+    if (error < 0) {
+        pendingReplies.remove(replyId);
+        if (callback) {
+            callback(error, QVariant());
+        } else {
+            reportError("MPV设置参数错误：", error);
+        }
+    }
+}
+
 #endif // CONTROLLER_H
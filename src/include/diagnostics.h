@@ -0,0 +1,84 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+
+#include <atomic>
+
+#include "ring_buffer.h"
+
+/*!
+ * @brief 非阻塞的错误与诊断通道
+ *
+ * report()可在任意线程中调用，只把错误写入无锁环形队列，再投递一次主线程处理，不会弹出模态对话框。
+ * 主线程中按错误码限频：同一错误码在限频窗口内只提示一次，其余次数累计到记录中。
+ * 最近的记录保留在内存中，可导出为诊断日志。
+ */
+class Diagnostics : public QObject {
+Q_OBJECT
+
+public:
+    explicit Diagnostics(QObject *parent = nullptr);
+
+    void report(const QString &message, int code);
+
+    bool exportLog(const QString &fileName);
+
+signals:
+
+    /*!
+     * @brief 需要提示给用户的错误，已经过限频
+     */
+    void errorShown(const QString &text);
+
+private:
+    /*!
+     * @brief 队列中的错误，定长以便无锁传递
+     */
+    struct PendingError {
+        qint64 timestamp = 0;
+
+        int code = 0;
+
+        char message[240] = {};
+    };
+
+    /*!
+     * @brief 保留的错误记录，repeats为限频窗口内被合并的次数
+     */
+    struct Record {
+        QDateTime time;
+
+        int code;
+
+        QString message;
+
+        int repeats;
+    };
+
+    void drain();
+
+private:
+    static constexpr int maximumRecords = 500;
+
+    static constexpr qint64 rateLimitWindow = 5000;
+
+    RingBuffer<PendingError, 256> pending;
+
+    std::atomic<bool> drainScheduled;
+
+    std::atomic<int> dropped;
+
+    QList<Record> records;
+
+    QHash<int, qint64> lastShown;
+
+    QElapsedTimer clock;
+};
+
+#endif //DIAGNOSTICS_H
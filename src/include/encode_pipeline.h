@@ -0,0 +1,74 @@
+#ifndef ENCODE_PIPELINE_H
+#define ENCODE_PIPELINE_H
+
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QMutex>
+#include <QList>
+
+#include <atomic>
+#include <functional>
+
+#include "frame_grabber.h"
+
+/*!
+ * @brief 取帧线程与编码线程池组成的有界流水线
+ *
+ * 若干取帧线程各自使用独立的FrameGrabber解码，取到的帧通过submit()交给线程池编码保存。
+ * 待编码的任务数有上限，编码跟不上时取帧线程在submit()中等待，内存占用不随帧数增长。
+ * 取帧线程与编码任务全部结束后调用一次finished（在最后结束的线程中）。
+ * 析构时取消并等待所有线程与任务；任务通常引用所有者，因此应声明为所有者的最后一个成员，先于其他成员销毁。
+ */
+class EncodePipeline {
+public:
+    /*!
+     * @brief 取帧线程的主体，worker为线程序号
+     */
+    using Worker = std::function<void(int worker)>;
+
+    using Finished = std::function<void()>;
+
+    EncodePipeline();
+
+    ~EncodePipeline();
+
+    EncodePipeline(const EncodePipeline &) = delete;
+
+    EncodePipeline &operator=(const EncodePipeline &) = delete;
+
+    void start(int workerCount, const Worker &worker, const Finished &finished,
+               QThread::Priority priority = QThread::InheritPriority);
+
+    void submit(const std::function<void()> &task);
+
+    void attach(FrameGrabber *grabber);
+
+    void detach(FrameGrabber *grabber);
+
+    void cancel();
+
+    [[nodiscard]] bool isCancelled() const;
+
+private:
+    void release();
+
+private:
+    QList<QThread *> workers;
+
+    QThreadPool encodePool;
+
+    QSemaphore encodeSlots;
+
+    QMutex grabberMutex;
+
+    QList<FrameGrabber *> activeGrabbers;
+
+    Finished finished;
+
+    std::atomic<bool> cancelled;
+
+    std::atomic<int> outstanding;
+};
+
+#endif //ENCODE_PIPELINE_H
@@ -0,0 +1,70 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QString>
+#include <QByteArray>
+#include <QImage>
+
+#include <atomic>
+
+#include "mpv/client.h"
+
+/*!
+ * @brief 当前帧截图
+ *
+ * 截图、编码与保存都在后台线程中完成：screenshot-raw的结果直接作为QImage的像素数据，不经过临时文件，
+ * 也不阻塞界面与MPV的播放，可以快速连续截图。保存位置与文件名模板等选项保存在settings.ini中。
+ */
+class FrameCapture : public QObject {
+Q_OBJECT
+
+public:
+    /*!
+     * @brief 截图选项
+     */
+    struct Options {
+        QString directory;
+        QString fileTemplate;   // 可用变量：%title%、%time%、%date%、%n%
+        QByteArray format;      // png、jpg或webp
+        int quality;
+        bool copyToClipboard;
+    };
+
+    explicit FrameCapture(mpv_handle *mpv, QObject *parent = nullptr);
+
+    ~FrameCapture() override;
+
+    static Options loadOptions();
+
+    static void saveOptions(const Options &options);
+
+    static QString expandTemplate(const QString &fileTemplate, const QString &title, double timePos, int number);
+
+    void capture();
+
+signals:
+
+    /*!
+     * @brief 截图已保存，在后台线程中发出
+     */
+    void captured(const QString &fileName);
+
+    /*!
+     * @brief 截图失败，在后台线程中发出
+     */
+    void captureFailed(const QString &message);
+
+private:
+    void captureTask(const Options &options, int number);
+
+private:
+    mpv_handle *mpv;
+
+    QThreadPool pool;
+
+    std::atomic<int> counter;
+};
+
+#endif //FRAME_CAPTURE_H
@@ -0,0 +1,70 @@
+#ifndef FRAME_GRABBER_H
+#define FRAME_GRABBER_H
+
+#include <QString>
+#include <QImage>
+#include <QElapsedTimer>
+
+#include <atomic>
+
+#include "mpv/client.h"
+#include "local_stream.h"
+
+/*!
+ * @brief 基于独立MPV实例的取帧器
+ *
+ * 实例不输出视频与音频（vo=null、ao=null），只解码视频并通过screenshot-raw取得帧数据，
+ * 与主播放器互不影响。除abort()外，所有接口须在同一线程中调用，适合放在后台线程中使用。
+ */
+class FrameGrabber {
+public:
+    /*!
+     * @brief width大于0时帧会被缩放到该宽度（保持宽高比），否则保持原始尺寸；
+     * skipLoopFilter跳过H.264/HEVC的环路滤波，解码更快但画面有块效应，只适合小尺寸的缩略图
+     */
+    explicit FrameGrabber(int width = 0, bool skipLoopFilter = false);
+
+    ~FrameGrabber();
+
+    FrameGrabber(const FrameGrabber &) = delete;
+
+    FrameGrabber &operator=(const FrameGrabber &) = delete;
+
+    [[nodiscard]] mpv_handle *getMpvInstance() const;
+
+    bool open(const QString &path, int timeout = 10000);
+
+    [[nodiscard]] double getDuration() const;
+
+    QImage grab(double seconds, bool exact = false, int timeout = 5000);
+
+    QImage grabCurrent();
+
+    bool step(int timeout = 5000);
+
+    [[nodiscard]] double getTimePos() const;
+
+    void abort();
+
+    static QImage toImage(mpv_node *node);
+
+private:
+    /*!
+     * @brief 监听的属性，数值作为reply_userdata区分事件来源
+     */
+    enum ObservedProperty : uint64_t {
+        TimePosProperty = 1,
+        EofReachedProperty
+    };
+
+    bool waitForEvent(mpv_event_id id, int timeout);
+
+private:
+    mpv_handle *mpv;
+
+    double duration;
+
+    std::atomic<bool> aborted;
+};
+
+#endif //FRAME_GRABBER_H
@@ -0,0 +1,42 @@
+#ifndef FRAME_INDEX_H
+#define FRAME_INDEX_H
+
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+
+#include <atomic>
+
+/*!
+ * @brief 每个媒体文件的帧时间戳与关键帧索引
+ *
+ * 在后台用独立的MPV实例以不计时、跳过IDCT的方式快速解码整个文件，
+ * 通过lavfi的showinfo滤镜日志得到每一帧的显示时间与是否为关键帧。
+ * 结果按文件缓存，可变帧率的文件也能得到准确的帧号与上一帧位置。
+ */
+class FrameIndex {
+public:
+    static QSharedPointer<const FrameIndex> load(const QString &path);
+
+    static QSharedPointer<const FrameIndex> build(const QString &path, const std::atomic<bool> &aborted);
+
+    [[nodiscard]] int frameCount() const;
+
+    [[nodiscard]] int frameAt(double time) const;
+
+    [[nodiscard]] double timeOf(int frame) const;
+
+    [[nodiscard]] bool isKeyframe(int frame) const;
+
+private:
+    static QString cachePath(const QString &path);
+
+    bool save(const QString &path) const;
+
+private:
+    QVector<double> times;
+
+    QVector<bool> keyframes;
+};
+
+#endif //FRAME_INDEX_H
@@ -0,0 +1,54 @@
+#ifndef INPUT_COALESCER_H
+#define INPUT_COALESCER_H
+
+#include <QString>
+#include <QHash>
+
+#include <functional>
+
+/*!
+ * @brief 合并连续的相对调整输入
+ *
+ * 每个通道（跳转、音量、速度等）同一时间只有一个请求交给MPV，请求完成前到来的调整量累加，
+ * 完成后一次性发出累计值。按住按键时不会在MPV中积压大量请求，也不会在松开后继续越过目标。
+ * 所有接口须在主线程中调用。
+ */
+class InputCoalescer {
+public:
+    /*!
+     * @brief 发出累计调整量，请求完成（无论成功与否）后须调用complete()
+     */
+    using Sender = std::function<void(double amount)>;
+
+    void addChannel(const QString &key, const Sender &sender);
+
+    void add(const QString &key, double amount);
+
+    void complete(const QString &key);
+
+    void discard(const QString &key);
+
+    void reset();
+
+    [[nodiscard]] double pending(const QString &key) const;
+
+private:
+    struct Channel {
+        Sender sender;
+
+        bool inFlight = false;
+
+        double inFlightAmount = 0.0;
+
+        double queuedAmount = 0.0;
+
+        bool hasQueued = false;
+    };
+
+    void send(Channel &channel);
+
+private:
+    QHash<QString, Channel> channels;
+};
+
+#endif //INPUT_COALESCER_H
@@ -0,0 +1,54 @@
+#ifndef IO_URING_QUEUE_H
+#define IO_URING_QUEUE_H
+
+#include <QByteArray>
+#include <QMutex>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/*!
+ * @brief 基于Linux io_uring的定位读取队列，所有预读流共用一个实例
+ *
+ * 读取请求直接提交到内核的提交队列，由一个专用线程等待完成队列并调用完成回调，
+ * 在途读取不占用线程。内核不支持io_uring、被安全策略禁用或不在Linux上时instance()返回nullptr，
+ * 调用方改用线程池中的pread。不依赖liburing，直接使用io_uring_setup与io_uring_enter系统调用。
+ */
+class IoUringQueue {
+public:
+    /*!
+     * @brief 完成回调，count为读到的字节数，出错时为-1；在完成线程中调用，data为读到的数据
+     */
+    using Completion = std::function<void(int64_t count, QByteArray &data)>;
+
+    static IoUringQueue *instance();
+
+    bool submitRead(int fd, int64_t offset, int64_t length, Completion completion);
+
+private:
+    struct Ring;
+
+    struct Request;
+
+    IoUringQueue();
+
+    ~IoUringQueue();
+
+    bool initialize();
+
+    bool submit(Request *request);
+
+    void run();
+
+    void finish(Request *request, int64_t count);
+
+private:
+    std::unique_ptr<Ring> ring;
+
+    QMutex submitMutex;     // 提交队列只允许一个线程同时写入
+
+    std::atomic<unsigned> inFlight{0};
+};
+
+#endif //IO_URING_QUEUE_H
@@ -0,0 +1,62 @@
+#ifndef LOCAL_STREAM_H
+#define LOCAL_STREAM_H
+
+#include <QString>
+#include <QFileInfo>
+#include <QStorageInfo>
+#include <QDebug>
+
+#include "mpv/client.h"
+#include "mpv/stream_cb.h"
+
+/*!
+ * @brief 通过astra://协议交给MPV读取的本地文件流基类
+ *
+ * 本地磁盘上的大文件使用内存映射读取（MappedStream），网络挂载的文件使用异步预读（ReadAheadStream）。
+ * 同一套读取方式也用于archive://协议，直接读取归档文件中未压缩成员所在的一段。
+ * 除cancel()外，所有接口均在MPV的解复用线程中调用。
+ */
+class LocalStream {
+public:
+    static constexpr const char *protocol = "astra";
+
+    virtual ~LocalStream() = default;
+
+    static void registerProtocol(mpv_handle *mpv);
+
+    static bool isSuitable(const QString &path);
+
+    static bool isNetworkPath(const QString &path);
+
+    static QString toUri(const QString &path);
+
+protected:
+    virtual bool open() = 0;
+
+    virtual int64_t read(char *buffer, uint64_t bytes) = 0;
+
+    virtual int64_t seek(int64_t offset) = 0;
+
+    [[nodiscard]] virtual int64_t size() const = 0;
+
+    virtual void cancel() {}
+
+private:
+    static int openStream(const QString &path, int64_t offset, int64_t length, mpv_stream_cb_info *info);
+
+    static int onOpen(void *userData, char *uri, mpv_stream_cb_info *info);
+
+    static int onOpenArchive(void *userData, char *uri, mpv_stream_cb_info *info);
+
+    static int64_t onRead(void *cookie, char *buffer, uint64_t bytes);
+
+    static int64_t onSeek(void *cookie, int64_t offset);
+
+    static int64_t onSize(void *cookie);
+
+    static void onClose(void *cookie);
+
+    static void onCancel(void *cookie);
+};
+
+#endif //LOCAL_STREAM_H
@@ -0,0 +1,60 @@
+#ifndef LOG_VIEWER_H
+#define LOG_VIEWER_H
+
+#include <QWidget>
+#include <QPlainTextEdit>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTimer>
+#include <QStringList>
+
+#include "controller.h"
+
+/*!
+ * @brief MPV日志窗口
+ *
+ * 只在窗口可见时用定时器批量读取新日志，每次刷新最多一次文本追加，不会为每行日志更新控件。
+ * 级别过滤同时决定MPV发送日志的级别，模块过滤按日志前缀匹配。
+ */
+class LogViewer : public QWidget {
+Q_OBJECT
+
+public:
+    explicit LogViewer(Controller *controller, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void refresh();
+
+    void rebuild();
+
+    void exportLog();
+
+    [[nodiscard]] bool accepts(const LogRecord &record) const;
+
+private:
+    static constexpr int refreshInterval = 250;
+
+    Controller *controller;
+
+    QComboBox *levelComboBox;
+
+    QLineEdit *moduleLineEdit;
+
+    QPlainTextEdit *textEdit;
+
+    QTimer refreshTimer;
+
+    mpv_log_level maximumLevel;
+
+    QStringList modules;
+
+    uint64_t lastSequence;
+};
+
+#endif //LOG_VIEWER_H
@@ -0,0 +1,48 @@
+#ifndef MAPPED_STREAM_H
+#define MAPPED_STREAM_H
+
+#include <QString>
+#include <QFile>
+
+#include "local_stream.h"
+
+/*!
+ * @brief 基于内存映射的本地文件流
+ *
+ * 读取直接从映射区域拷贝，并按读取位置向前滑动预读窗口，提示系统提前把后续数据读入页缓存。
+ */
+class MappedStream : public LocalStream {
+public:
+    explicit MappedStream(const QString &path, int64_t offset = 0, int64_t length = -1);
+
+    ~MappedStream() override;
+
+protected:
+    bool open() override;
+
+    int64_t read(char *buffer, uint64_t bytes) override;
+
+    int64_t seek(int64_t offset) override;
+
+    [[nodiscard]] int64_t size() const override;
+
+private:
+    void adviseWindow(int64_t offset);
+
+private:
+    QFile file;
+
+    uchar *data;
+
+    int64_t baseOffset;     // 映射在文件中的起始位置，用于直接读取归档中的成员
+
+    int64_t length;
+
+    int64_t fileSize;
+
+    int64_t position;
+
+    int64_t windowEnd;
+};
+
+#endif //MAPPED_STREAM_H
@@ -0,0 +1,98 @@
+#ifndef MPV_EVENT_THREAD_H
+#define MPV_EVENT_THREAD_H
+
+#include <QThread>
+#include <QVariant>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "mpv/client.h"
+#include "ring_buffer.h"
+
+/*!
+ * @brief 从MPV事件解码出的定长事件
+ *
+ * 数值属性直接保存在number/integer中；节点类型的属性与命令返回值在事件线程中转换为QVariant，
+ * 由node指向，所有权随事件转交给消费者，处理完后须delete。
+ */
+struct MpvEvent {
+    mpv_event_id id = MPV_EVENT_NONE;
+
+    int error = 0;
+
+    uint64_t replyUserdata = 0;
+
+    /*!
+     * @brief 属性变化的格式，属性不可用时为MPV_FORMAT_NONE
+     */
+    mpv_format format = MPV_FORMAT_NONE;
+
+    /*!
+     * @brief MPV_FORMAT_DOUBLE属性的值
+     */
+    double number = 0.0;
+
+    /*!
+     * @brief MPV_FORMAT_FLAG与MPV_FORMAT_INT64属性的值，MPV_EVENT_END_FILE的结束原因
+     */
+    int64_t integer = 0;
+
+    QVariant *node = nullptr;
+};
+
+/*!
+ * @brief 专用的MPV事件线程
+ *
+ * 线程阻塞在mpv_wait_event上，把事件解码为MpvEvent写入单生产者单消费者的无锁队列。
+ * 每取空一次MPV事件队列调用一次batchReady（在事件线程中），由调用方投递一次主线程处理，
+ * 主线程再通过pop()取出整批事件。界面处理再慢也不会积压MPV内部的事件队列。
+ */
+class MpvEventThread {
+public:
+    using BatchReady = std::function<void()>;
+
+    /*!
+     * @brief 日志消息不进入事件队列，直接在事件线程中交给该回调
+     */
+    using LogHandler = std::function<void(const mpv_event_log_message *message)>;
+
+    MpvEventThread(mpv_handle *mpv, BatchReady batchReady);
+
+    ~MpvEventThread();
+
+    MpvEventThread(const MpvEventThread &) = delete;
+
+    MpvEventThread &operator=(const MpvEventThread &) = delete;
+
+    void setLogHandler(LogHandler handler);
+
+    void start();
+
+    void stop();
+
+    bool pop(MpvEvent &event);
+
+private:
+    void run();
+
+    static MpvEvent decode(const mpv_event *event);
+
+    void enqueue(const MpvEvent &event);
+
+private:
+    mpv_handle *mpv;
+
+    BatchReady batchReady;
+
+    LogHandler logHandler;
+
+    QThread *thread;
+
+    RingBuffer<MpvEvent, 1024> queue;
+
+    std::atomic<bool> stopping;
+};
+
+#endif //MPV_EVENT_THREAD_H
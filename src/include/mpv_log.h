@@ -0,0 +1,64 @@
+#ifndef MPV_LOG_H
+#define MPV_LOG_H
+
+#include <QString>
+#include <QVector>
+#include <QMutex>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "mpv/client.h"
+
+/*!
+ * @brief MPV日志记录，定长以便预先分配
+ */
+struct LogRecord {
+    /*!
+     * @brief 写入序号，从1开始连续递增
+     */
+    uint64_t sequence = 0;
+
+    qint64 timestamp = 0;
+
+    mpv_log_level level = MPV_LOG_LEVEL_NONE;
+
+    char prefix[32] = {};
+
+    char text[256] = {};
+};
+
+/*!
+ * @brief 有界的MPV日志缓冲区
+ *
+ * 记录在构造时一次性分配，写满后覆盖最旧的记录，打开详细日志也不会无限占用内存。
+ * append()在MPV事件线程中调用，读取接口在主线程中调用，临界区内只复制定长记录。
+ */
+class MpvLog {
+public:
+    static constexpr int capacity = 8192;
+
+    MpvLog();
+
+    void append(const mpv_event_log_message *message);
+
+    [[nodiscard]] uint64_t lastSequence() const;
+
+    [[nodiscard]] QVector<LogRecord> recordsAfter(uint64_t sequence) const;
+
+    bool exportLog(const QString &fileName) const;
+
+    static QString format(const LogRecord &record);
+
+    static const char *levelName(mpv_log_level level);
+
+private:
+    mutable QMutex mutex;
+
+    std::vector<LogRecord> records;
+
+    std::atomic<uint64_t> written;
+};
+
+#endif //MPV_LOG_H
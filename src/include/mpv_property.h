@@ -0,0 +1,144 @@
+#ifndef MPV_PROPERTY_H
+#define MPV_PROPERTY_H
+
+#include <QString>
+
+#include <cstdint>
+
+#include "mpv/client.h"
+
+/*!
+ * @brief 编译期的MPV属性表
+ *
+ * 每个属性是一个空结构体，给出属性名与C++类型，MPV格式由类型决定。读写时直接使用MPV的原生格式
+ * （MPV_FORMAT_DOUBLE、MPV_FORMAT_FLAG、MPV_FORMAT_INT64）在栈上传递数值，不经过QVariant与mpv_node，
+ * 不产生堆分配。字符串属性需要复制，只用于非频繁调用的场合。
+ */
+namespace MpvProperty {
+
+/*!
+ * @brief C++类型与MPV格式的对应关系
+ */
+template<typename T>
+struct Traits;
+
+template<>
+struct Traits<double> {
+    static constexpr mpv_format format = MPV_FORMAT_DOUBLE;
+    using Native = double;
+
+    static double fromNative(Native value) { return value; }
+
+    static Native toNative(double value) { return value; }
+};
+
+template<>
+struct Traits<bool> {
+    static constexpr mpv_format format = MPV_FORMAT_FLAG;
+    using Native = int;
+
+    static bool fromNative(Native value) { return value != 0; }
+
+    static Native toNative(bool value) { return value ? 1 : 0; }
+};
+
+template<>
+struct Traits<int64_t> {
+    static constexpr mpv_format format = MPV_FORMAT_INT64;
+    using Native = int64_t;
+
+    static int64_t fromNative(Native value) { return value; }
+
+    static Native toNative(int64_t value) { return value; }
+};
+
+#define MPV_PROPERTY(Name, property, CppType)              \
+    struct Name {                                          \
+        static constexpr const char *name = property;      \
+        using Type = CppType;                              \
+    };
+
+/*!
+ * @brief 播放状态
+ */
+MPV_PROPERTY(TimePos, "time-pos", double)
+MPV_PROPERTY(Duration, "duration", double)
+MPV_PROPERTY(Pause, "pause", bool)
+MPV_PROPERTY(Mute, "mute", bool)
+MPV_PROPERTY(Volume, "volume", double)
+MPV_PROPERTY(Speed, "speed", double)
+MPV_PROPERTY(AudioDelay, "audio-delay", double)
+
+/*!
+ * @brief 画面
+ */
+MPV_PROPERTY(VideoZoom, "video-zoom", double)
+MPV_PROPERTY(VideoPanX, "video-pan-x", double)
+MPV_PROPERTY(VideoPanY, "video-pan-y", double)
+MPV_PROPERTY(DisplayWidth, "dwidth", int64_t)
+MPV_PROPERTY(DisplayHeight, "dheight", int64_t)
+
+/*!
+ * @brief 播放选项
+ */
+MPV_PROPERTY(Untimed, "untimed", bool)
+
+/*!
+ * @brief 字幕
+ */
+MPV_PROPERTY(SubtitleTrack, "sid", int64_t)
+MPV_PROPERTY(SubtitleDelay, "sub-delay", double)
+MPV_PROPERTY(SubtitleFontSize, "sub-font-size", double)
+
+#undef MPV_PROPERTY
+
+/*!
+ * @brief 读取属性，失败时返回MPV错误码且不修改value
+ */
+template<typename Prop>
+int get(mpv_handle *mpv, typename Prop::Type &value) {
+    using T = Traits<typename Prop::Type>;
+    typename T::Native native{};
+    const int error = mpv_get_property(mpv, Prop::name, T::format, &native);
+    if (error >= 0) {
+        value = T::fromNative(native);
+    }
+    return error;
+}
+
+/*!
+ * @brief 同步设置属性
+ */
+template<typename Prop>
+int set(mpv_handle *mpv, typename Prop::Type value) {
+    using T = Traits<typename Prop::Type>;
+    typename T::Native native = T::toNative(value);
+    return mpv_set_property(mpv, Prop::name, T::format, &native);
+}
+
+/*!
+ * @brief 异步设置属性，MPV在调用返回前已复制数值，完成后以replyUserdata发出MPV_EVENT_SET_PROPERTY_REPLY
+ */
+template<typename Prop>
+int setAsync(mpv_handle *mpv, uint64_t replyUserdata, typename Prop::Type value) {
+    using T = Traits<typename Prop::Type>;
+    typename T::Native native = T::toNative(value);
+    return mpv_set_property_async(mpv, replyUserdata, Prop::name, T::format, &native);
+}
+
+/*!
+ * @brief 读取字符串属性
+ */
+inline QString getString(mpv_handle *mpv, const char *name) {
+    char *value = mpv_get_property_string(mpv, name);
+    if (!value) {
+        return {};
+    }
+    QString result = QString::fromUtf8(value);
+    mpv_free(value);
+    return result;
+}
+
+}
+
+#endif //MPV_PROPERTY_H
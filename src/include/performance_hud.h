@@ -0,0 +1,67 @@
+#ifndef PERFORMANCE_HUD_H
+#define PERFORMANCE_HUD_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include <QVariant>
+
+#include "controller.h"
+
+/*!
+ * @brief 播放性能信息叠加层
+ *
+ * 通过osd-overlay由MPV直接绘制在画面上，不经过Qt控件，不会引起重新布局。显示时监听丢帧、
+ * 延迟帧、帧率、音画同步、缓存时长与解码方式等属性，属性变化后合并刷新，隐藏时取消监听。
+ */
+class PerformanceHud : public QObject {
+Q_OBJECT
+
+public:
+    explicit PerformanceHud(Controller *controller, QObject *parent = nullptr);
+
+    ~PerformanceHud() override;
+
+    [[nodiscard]] bool isVisible() const;
+
+    void setVisible(bool show);
+
+private:
+    /*!
+     * @brief 监听的属性，reply_userdata从statisticBase开始，与Controller自身监听的属性区分
+     */
+    enum Statistic {
+        FrameDropCount,
+        DecoderFrameDropCount,
+        DelayedFrameCount,
+        EstimatedFps,
+        AvSync,
+        CacheDuration,
+        HwdecCurrent,
+        DecoderThreads,
+        StatisticCount
+    };
+
+    static constexpr uint64_t statisticBase = 0x48554400;
+
+    static constexpr int overlayId = 1;
+
+    static constexpr int refreshInterval = 200;
+
+    void onPropertyChanged(const MpvEvent &event);
+
+    void render();
+
+    [[nodiscard]] QString value(Statistic statistic, int precision = 0) const;
+
+private:
+    Controller *controller;
+
+    bool visible;
+
+    QVariant values[StatisticCount];
+
+    QTimer refreshTimer;
+};
+
+#endif //PERFORMANCE_HUD_H
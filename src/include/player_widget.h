@@ -0,0 +1,73 @@
+#ifndef PLAYER_WIDGET_H
+#define PLAYER_WIDGET_H
+
+#include <QOpenGLWidget>
+#include <QOpenGLContext>
+#include <QDebug>
+
+#include "mpv/client.h"
+#include "mpv/render_gl.h"
+#include "trace.h"
+
+/*!
+ * @brief 单帧的呈现时间信息，时间单位为微秒，与mpv_get_time_us()同基准
+ */
+struct FrameTiming {
+    int64_t targetTime;     // MPV期望的显示时间，重绘帧或垂直同步模式下可能为0
+    int64_t renderTime;     // mpv_render_context_render()耗时
+    int64_t presentTime;    // 缓冲区交换完成的时间
+    bool redraw;            // 是否为重绘帧
+    bool repeat;            // 是否为重复帧
+};
+
+Q_DECLARE_METATYPE(FrameTiming)
+
+/*!
+ * @brief 通过MPV渲染API在QOpenGLWidget中绘制视频
+ */
+class PlayerWidget : public QOpenGLWidget {
+Q_OBJECT
+
+public:
+    explicit PlayerWidget(QWidget *parent = nullptr);
+
+    ~PlayerWidget() override;
+
+    void setMpvInstance(mpv_handle *handle);
+
+    void releaseRenderContext();
+
+signals:
+
+    /*!
+     * @brief 一帧画面完成呈现后发出，携带该帧的时间信息
+     */
+    void framePresented(const FrameTiming &timing);
+
+protected:
+    void initializeGL() override;
+
+    void paintGL() override;
+
+private:
+    static void *getProcAddress(void *ctx, const char *name);
+
+    static void onMpvRenderUpdate(void *ctx);
+
+    void createRenderContext();
+
+    void handleRenderUpdate();
+
+    void handleFrameSwapped();
+
+private:
+    mpv_handle *mpv;
+
+    mpv_render_context *mpvGL;
+
+    bool pendingPresent;
+
+    FrameTiming pendingTiming;
+};
+
+#endif //PLAYER_WIDGET_H
@@ -0,0 +1,72 @@
+#ifndef PREVIEW_EXTRACTOR_H
+#define PREVIEW_EXTRACTOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QImage>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+
+#include "encode_pipeline.h"
+
+/*!
+ * @brief 并行提取预览图
+ *
+ * 将时间点按顺序分成互不重叠的若干段，每段由一个后台线程中的独立FrameGrabber取帧，
+ * 取到的图像交给线程池处理（编码、保存等），不影响主播放器的播放。
+ * 待处理的图像数量有上限，取帧快于编码时取帧线程会等待，避免占用过多内存。
+ */
+class PreviewExtractor : public QObject {
+Q_OBJECT
+
+public:
+    /*!
+     * @brief 在线程池中处理一张图像，index为时间点的序号，time为取到的帧的实际位置
+     * （按关键帧跳转，可能早于请求的时间点），返回是否成功
+     */
+    using ImageHandler = std::function<bool(int index, double time, const QImage &image)>;
+
+    explicit PreviewExtractor(QObject *parent = nullptr);
+
+    void start(const QString &path, const QVector<double> &times, const ImageHandler &handler, int width = 0);
+
+    void cancel();
+
+    static int defaultWorkerCount();
+
+signals:
+
+    /*!
+     * @brief 完成（含失败）的图像数量变化
+     */
+    void progressChanged(int completed, int total);
+
+    /*!
+     * @brief 所有取帧与处理任务结束
+     */
+    void finished(int succeeded, bool cancelled);
+
+private:
+    void runWorker(int first, int last);
+
+    void taskDone(bool ok);
+
+private:
+    QString path;
+
+    QVector<double> times;
+
+    ImageHandler handler;
+
+    int width;
+
+    std::atomic<int> completed;
+
+    std::atomic<int> succeeded;
+
+    EncodePipeline pipeline;
+};
+
+#endif //PREVIEW_EXTRACTOR_H
@@ -0,0 +1,63 @@
+#ifndef READ_AHEAD_STREAM_H
+#define READ_AHEAD_STREAM_H
+
+#include <QString>
+#include <QThreadPool>
+
+#include <memory>
+
+#include "local_stream.h"
+
+/*!
+ * @brief 异步预读的文件流，适用于单次读取延迟高的网络存储
+ *
+ * 在当前读取位置之前始终保持若干个按块提交的定位读取：Linux上提交到io_uring（IoUringQueue），
+ * 不可用时提交到线程池执行pread（Windows上为重叠ReadFile）。
+ * 读取回调只从已完成的块中拷贝数据，不自行发起同步读取。
+ */
+class ReadAheadStream : public LocalStream {
+public:
+    explicit ReadAheadStream(const QString &path, int64_t offset = 0, int64_t length = -1);
+
+    ~ReadAheadStream() override;
+
+protected:
+    bool open() override;
+
+    int64_t read(char *buffer, uint64_t bytes) override;
+
+    int64_t seek(int64_t offset) override;
+
+    [[nodiscard]] int64_t size() const override;
+
+    void cancel() override;
+
+private:
+    struct State;
+
+    void restartPipeline(int64_t offset);
+
+    void fillPipeline();
+
+    void scheduleBlock(int64_t offset, int64_t length);
+
+    static void completeBlock(const std::shared_ptr<State> &shared, int64_t offset, quint64 generation,
+                              int64_t count, QByteArray &data);
+
+    static QThreadPool *readPool();
+
+private:
+    QString path;
+
+    std::shared_ptr<State> state;
+
+    int64_t baseOffset;     // 流在文件中的起始位置，用于直接读取归档中的成员
+
+    int64_t length;
+
+    int64_t fileSize;
+
+    int64_t position;
+};
+
+#endif //READ_AHEAD_STREAM_H
@@ -0,0 +1,113 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*!
+ * @brief 固定容量的无锁环形队列
+ *
+ * 每个槽位带有序号，生产者与消费者通过序号判断槽位归属（Vyukov有界队列），
+ * 多个线程可同时入队或出队，任何一方都不会阻塞。槽位在构造时一次性分配，之后不再分配内存；
+ * 队列满时push()直接返回false，由调用方决定丢弃或计数。Capacity须为2的幂。
+ */
+template<typename T, size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    RingBuffer() : slots(new Slot[Capacity]), enqueuePosition(0), dequeuePosition(0) {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RingBuffer(const RingBuffer &) = delete;
+
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    /*!
+     * @brief 入队，队列已满时返回false
+     */
+    bool push(const T &item) {
+        Slot *slot = nullptr;
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots[position & mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        slot->item = item;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * @brief 出队，队列为空时返回false
+     */
+    bool pop(T &item) {
+        Slot *slot = nullptr;
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots[position & mask];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        item = slot->item;
+        slot->sequence.store(position + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * @brief 当前元素数量，并发修改时只是近似值
+     */
+    [[nodiscard]] size_t size() const {
+        const size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+        const size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t mask = Capacity - 1;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+
+        T item;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+
+    /*!
+     * @brief 入队与出队位置分处不同缓存行，避免生产者与消费者互相干扰
+     */
+    alignas(64) std::atomic<size_t> enqueuePosition;
+
+    alignas(64) std::atomic<size_t> dequeuePosition;
+};
+
+#endif //RING_BUFFER_H
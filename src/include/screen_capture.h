@@ -9,30 +9,64 @@
 #include <QStandardPaths>
 #include <QDateTime>
 #include <QInputDialog>
+#include <QComboBox>
+#include <QProgressDialog>
+#include <QPointer>
+#include <QMessageBox>
+#include <QGroupBox>
+#include <QFormLayout>
+#include <QLineEdit>
+#include <QCheckBox>
 
 #include "controller.h"
+#include "preview_extractor.h"
+#include "contact_sheet.h"
+#include "frame_capture.h"
 
 class ScreenCapture : public QDialog {
 Q_OBJECT
 
 public:
-    explicit ScreenCapture(mpv_handle *mpv, QWidget *parent = nullptr);
+    ScreenCapture(mpv_handle *mpv, FrameCapture *frameCapture, QWidget *parent = nullptr);
+
+    static ScreenCapture *present(ScreenCapture *&instance, mpv_handle *mpv, FrameCapture *frameCapture,
+                                  QWidget *parent);
 
 private:
+    QGroupBox *createCaptureOptionsGroup();
+
+    void saveCaptureOptions();
 
     void on_captureCurrentFrameButton_clicked();
 
     void on_capturePreviewButton_clicked();
 
+    void on_captureContactSheetButton_clicked();
+
 private:
     int captureCount;
 
     QSpinBox *captureCountSpinBox;
 
+    QComboBox *previewFormatComboBox;
+
+    QComboBox *sheetFormatComboBox;
+
+    QSpinBox *sheetQualitySpinBox;
+
     mpv_handle *mpv;
 
-    [[nodiscard]] QVariant getProperty(const QString &name) const;
+    FrameCapture *frameCapture;
+
+    QLineEdit *captureDirectoryEdit;
+
+    QLineEdit *captureTemplateEdit;
+
+    QComboBox *captureFormatComboBox;
+
+    QSpinBox *captureQualitySpinBox;
 
+    QCheckBox *captureClipboardCheckBox;
 };
 
 
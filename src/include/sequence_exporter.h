@@ -0,0 +1,71 @@
+#ifndef SEQUENCE_EXPORTER_H
+#define SEQUENCE_EXPORTER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QByteArray>
+
+#include <atomic>
+
+#include "encode_pipeline.h"
+
+/*!
+ * @brief 导出A、B两点之间的每一帧
+ *
+ * 在后台线程中的独立FrameGrabber上精确跳转到A点，之后用frame-step逐帧顺序解码并通过screenshot-raw取帧，
+ * 取到的帧交给线程池编码保存。待编码的帧数有上限，编码跟不上时解码线程等待，内存占用不会随区间长度增长。
+ */
+class SequenceExporter : public QObject {
+Q_OBJECT
+
+public:
+    explicit SequenceExporter(QObject *parent = nullptr);
+
+    void start(const QString &path, double start, double end, const QString &directory, const QString &baseName,
+               const QByteArray &format);
+
+    void cancel();
+
+signals:
+
+    /*!
+     * @brief 已保存的帧数、最近解码帧的位置与平均每秒导出帧数
+     */
+    void progressChanged(int exported, double position, double framesPerSecond);
+
+    /*!
+     * @brief 导出结束
+     */
+    void finished(int exported, double framesPerSecond, bool cancelled);
+
+private:
+    void runDecoder();
+
+    void encodeFrame(int index, const QImage &image);
+
+    [[nodiscard]] double framesPerSecond() const;
+
+private:
+    QString path;
+
+    double startTime;
+
+    double endTime;
+
+    QString directory;
+
+    QString baseName;
+
+    QByteArray format;
+
+    QElapsedTimer timer;
+
+    std::atomic<int> exported;
+
+    std::atomic<double> position;
+
+    EncodePipeline pipeline;
+};
+
+#endif //SEQUENCE_EXPORTER_H
@@ -0,0 +1,137 @@
+#ifndef SESSION_TELEMETRY_H
+#define SESSION_TELEMETRY_H
+
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QJsonObject>
+#include <QTcpServer>
+
+#include "mpv_event_thread.h"
+
+class Controller;
+
+/*!
+ * @brief 播放会话的性能统计
+ *
+ * 每次打开文件或URL开始一个会话，记录首帧时间、缓冲中断次数与时长、丢帧数、跳转延迟（发出跳转到
+ * MPV_EVENT_PLAYBACK_RESTART）以及按时间加权的平均缓存时长。会话结束时以一行JSON追加到本地统计目录，
+ * 可选地在本机端口上以Prometheus文本格式提供累计值。配置保存在settings.ini的telemetry组中。
+ */
+class SessionTelemetry : public QObject {
+Q_OBJECT
+
+public:
+    explicit SessionTelemetry(Controller *controller);
+
+    ~SessionTelemetry() override;
+
+    void beginSession(const QString &media);
+
+    void endSession(const QString &reason);
+
+    void seekStarted();
+
+    [[nodiscard]] static QString defaultDirectory();
+
+private:
+    /*!
+     * @brief 监听的属性，reply_userdata从propertyBase开始
+     */
+    enum Property {
+        PausedForCache,
+        FrameDropCount,
+        DecoderFrameDropCount,
+        CacheDuration,
+        PropertyCount
+    };
+
+    static constexpr uint64_t propertyBase = 0x54454c00;
+
+    struct Session {
+        bool active = false;
+
+        QString media;
+
+        QDateTime started;
+
+        QElapsedTimer clock;
+
+        qint64 firstFrame = -1;
+
+        int rebufferCount = 0;
+
+        qint64 rebufferTime = 0;
+
+        qint64 rebufferStarted = -1;
+
+        qint64 droppedFrames = 0;
+
+        qint64 decoderDroppedFrames = 0;
+
+        QVector<qint64> seekLatencies;
+
+        qint64 seekStarted = -1;
+
+        double cacheDuration = 0.0;
+
+        double cacheIntegral = 0.0;
+
+        qint64 cacheChanged = -1;
+    };
+
+    void onFileEnded(int reason);
+
+    void onPlaybackRestart();
+
+    void onPropertyChanged(const MpvEvent &event);
+
+    void accumulateCache(qint64 now);
+
+    [[nodiscard]] QJsonObject summarize(const QString &reason);
+
+    void writeSession(const QJsonObject &summary) const;
+
+    void serveMetrics();
+
+    [[nodiscard]] QByteArray metricsText() const;
+
+private:
+    Controller *controller;
+
+    bool enabled;
+
+    QString directory;
+
+    QTcpServer *metricsServer;
+
+    Session session;
+
+    /*!
+     * @brief 当前会话仍在播放时打开新文件，旧文件的MPV_EVENT_END_FILE会在新会话开始后到达，需要忽略
+     */
+    int staleEndFiles;
+
+    /*!
+     * @brief 进程内所有已结束会话的累计值
+     */
+    qint64 sessionsTotal;
+
+    qint64 rebuffersTotal;
+
+    double rebufferSecondsTotal;
+
+    qint64 droppedFramesTotal;
+
+    qint64 seeksTotal;
+
+    double seekSecondsTotal;
+
+    qint64 firstFramesTotal;
+
+    double firstFrameSecondsTotal;
+};
+
+#endif //SESSION_TELEMETRY_H
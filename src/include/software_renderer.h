@@ -0,0 +1,58 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <QObject>
+#include <QDebug>
+
+#include "mpv/client.h"
+#include "mpv/render.h"
+#include "player_widget.h"
+
+/*!
+ * @brief 通过MPV软件渲染API将视频绘制到调用方提供的内存缓冲区，无需GPU与窗口
+ */
+class SoftwareRenderer : public QObject {
+Q_OBJECT
+
+public:
+    explicit SoftwareRenderer(mpv_handle *mpv, QObject *parent = nullptr);
+
+    ~SoftwareRenderer() override;
+
+    bool setTarget(void *buffer, int width, int height, size_t stride, const char *format = "rgb0");
+
+    void setBlockForTargetTime(bool block);
+
+    void release();
+
+    bool renderFrame();
+
+signals:
+
+    /*!
+     * @brief 一帧画面写入缓冲区后发出
+     */
+    void framePresented(const FrameTiming &timing);
+
+private:
+    static void onMpvRenderUpdate(void *ctx);
+
+    void handleRenderUpdate();
+
+private:
+    mpv_handle *mpv;
+
+    mpv_render_context *renderContext;
+
+    void *buffer;
+
+    int size[2];
+
+    size_t stride;
+
+    QByteArray format;
+
+    int blockForTargetTime;
+};
+
+#endif //SOFTWARE_RENDERER_H
@@ -7,6 +7,7 @@
 
 #include "mpv/client.h"
 #include "mpv/qthelper.hpp"
+#include "mpv_property.h"
 
 struct SubtitleInfo {
     int id;
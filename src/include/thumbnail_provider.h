@@ -0,0 +1,96 @@
+#ifndef THUMBNAIL_PROVIDER_H
+#define THUMBNAIL_PROVIDER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QCache>
+#include <QPair>
+#include <QImage>
+#include <QString>
+
+#include <deque>
+
+#include "frame_grabber.h"
+#include "thumbnail_sheet.h"
+
+/*!
+ * @brief 进度条悬停预览的缩略图来源
+ *
+ * 在低优先级的后台线程中使用独立的FrameGrabber按关键帧取帧，结果放入按（文件, 秒）索引的LRU缓存，
+ * 并预取悬停位置附近的缩略图。主播放器的解码不受影响。
+ * 空闲时按固定间隔补齐整个文件的缩略图并保存为ThumbnailSheet，之后再打开同一文件时直接从拼图中读取。
+ */
+class ThumbnailProvider : public QObject {
+Q_OBJECT
+
+public:
+    explicit ThumbnailProvider(int width = 160, QObject *parent = nullptr);
+
+    ~ThumbnailProvider() override;
+
+    static bool isSupported(const QString &path);
+
+    static int intervalFor(double duration);
+
+    void setFile(const QString &path);
+
+    void setDuration(double duration);
+
+    [[nodiscard]] bool hasFile() const;
+
+    [[nodiscard]] int keyFor(int second) const;
+
+    bool lookup(int second, QImage *image);
+
+    void request(int second);
+
+signals:
+
+    /*!
+     * @brief 缩略图生成完成，在后台线程中发出
+     */
+    void thumbnailReady(int second, const QImage &image);
+
+    /*!
+     * @brief 文件的缩略图拼图已生成并保存，在后台线程中发出
+     */
+    void sheetSaved(const QString &path);
+
+private:
+    using CacheKey = QPair<QString, int>;
+
+    void run();
+
+private:
+    const int width;
+
+    QThread *worker;
+
+    mutable QMutex mutex;
+
+    QWaitCondition pending;
+
+    std::deque<int> queue;
+
+    QCache<CacheKey, QImage> cache;
+
+    QSharedPointer<const ThumbnailSheet> sheet;
+
+    bool generatingSheet;
+
+    quint64 fileGeneration;
+
+    QString path;
+
+    int maximumSecond;
+
+    int step;
+
+    bool stopping;
+
+    FrameGrabber *activeGrabber;
+};
+
+#endif //THUMBNAIL_PROVIDER_H
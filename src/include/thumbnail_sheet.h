@@ -0,0 +1,41 @@
+#ifndef THUMBNAIL_SHEET_H
+#define THUMBNAIL_SHEET_H
+
+#include <QString>
+#include <QImage>
+#include <QMap>
+#include <QRect>
+#include <QSharedPointer>
+
+/*!
+ * @brief 持久化的缩略图拼图
+ *
+ * 每个媒体文件按固定时间间隔生成的缩略图拼接为一张JPEG，另存一个二进制索引（时间 → 拼图中的区域），
+ * 存放在缓存目录中，以路径、大小与修改时间的哈希命名。文件再次打开时直接读取，无需重新解码。
+ */
+class ThumbnailSheet {
+public:
+    static QString cacheDirectory();
+
+    static QString cacheKey(const QString &path);
+
+    static QSharedPointer<const ThumbnailSheet> load(const QString &path);
+
+    static QImage loadCover(const QString &path);
+
+    static QSharedPointer<const ThumbnailSheet> save(const QString &path, int interval, const QMap<int, QImage> &tiles);
+
+    [[nodiscard]] QImage tile(int second) const;
+
+private:
+    static bool readIndex(const QString &indexPath, int *interval, QMap<int, QRect> *rects);
+
+private:
+    QImage sprite;
+
+    int interval = 1;
+
+    QMap<int, QRect> rects;
+};
+
+#endif //THUMBNAIL_SHEET_H
@@ -0,0 +1,85 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstdint>
+
+/*!
+ * @brief 可选的Chrome trace_event追踪
+ *
+ * 默认关闭，设置环境变量ASTRAPLAY_TRACE为输出文件路径后启用，程序退出时写出JSON，可在chrome://tracing
+ * 或Perfetto中打开。每个线程第一次记录时分配自己的定长缓冲区，只有本线程写入，记录时不加锁；
+ * 缓冲区写满后覆盖最早的记录，长时间运行时保留最近的一段。未启用时每个追踪点只有一次原子读取。
+ */
+namespace Trace {
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void enable();
+
+int64_t now();
+
+/*!
+ * @brief 记录一段完成的区间（ph=X），name与category须为静态字符串，detail会被截断复制
+ */
+void complete(const char *name, const char *category, int64_t start, int64_t duration, const char *detail = nullptr);
+
+/*!
+ * @brief 记录一个瞬时事件（ph=i）
+ */
+void instant(const char *name, const char *category, const char *detail = nullptr);
+
+/*!
+ * @brief 为当前线程命名，显示在追踪视图的线程标题上，name须为静态字符串
+ */
+void setThreadName(const char *name);
+
+bool dump(const QString &fileName);
+
+}
+
+/*!
+ * @brief 作用域区间，析构时记录
+ */
+class TraceScope {
+public:
+    TraceScope(const char *name, const char *category, const char *detail = nullptr)
+            : name(name), category(category), detail(detail), start(Trace::isEnabled() ? Trace::now() : -1) {}
+
+    ~TraceScope() {
+        if (start >= 0) {
+            Trace::complete(name, category, start, Trace::now() - start, detail);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+
+    const char *category;
+
+    const char *detail;
+
+    int64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/*!
+ * @brief 记录所在作用域，TRACE_FUNCTION以函数签名为区间名
+ */
+#define TRACE_SCOPE(name, category, ...) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, category, ##__VA_ARGS__)
+#define TRACE_FUNCTION(category) TRACE_SCOPE(Q_FUNC_INFO, category)
+
+#endif //TRACE_H
@@ -1,10 +1,25 @@
 #include <QApplication>
 
 #include "application.h"
+#include "trace.h"
 
 int main(int argc, char *argv[]) {
     QApplication a(argc, argv);
 
+    /*!
+     * @brief 设置ASTRAPLAY_TRACE环境变量为输出文件路径时记录追踪，退出时写出
+     */
+    const QString tracePath = qEnvironmentVariable("ASTRAPLAY_TRACE");
+    if (!tracePath.isEmpty()) {
+        Trace::enable();
+        Trace::setThreadName("main");
+    }
+
+    /*!
+     * @brief 设置程序名称，缓存目录等位置以此命名
+     */
+    QApplication::setApplicationName("AstraPlay");
+
     /*!
      * @brief 设置程序图标
      */
@@ -28,5 +43,10 @@ int main(int argc, char *argv[]) {
 
     Application w;
     w.show();
-    return QApplication::exec();
+    const int result = QApplication::exec();
+
+    if (Trace::isEnabled() && !Trace::dump(tracePath)) {
+        qWarning() << "无法写入追踪文件" << tracePath;
+    }
+    return result;
 }